@@ -0,0 +1,244 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx. (https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Benchmark the generated kernels of the demo forms.
+
+Each form of each demo is JIT compiled for the requested scalar types,
+with and without sum factorization, and the batched tabulate_tensor
+kernel of each integral is timed over a batch of cells with random
+data. Reported are the compile time, the throughput in cells per second
+and, from the static flop estimate of the integral, in GFLOP/s.
+
+Results are written as JSON together with the commit and the compiler
+flags, so that runs on the same machine can be compared across commits::
+
+    python bench/bench_demos.py -o bench.json
+    python bench/bench_demos.py --demo HyperElasticity MassAction --scalar-type float64
+"""
+
+import argparse
+import json
+import pathlib
+import platform
+import subprocess
+import tempfile
+import time
+
+import numpy as np
+import ufl
+
+import ffcx
+import ffcx.codegeneration.jit
+from ffcx.codegeneration.utils import dtype_to_c_type, dtype_to_scalar_dtype
+
+demo_dir = pathlib.Path(__file__).resolve().parent.parent.joinpath("demo")
+
+integral_types = ("cell", "exterior_facet", "interior_facet")
+
+# Demos that are not implemented for complex scalars, or only for complex scalars
+real_only = ("BiharmonicHHJ", "BiharmonicRegge", "StabilisedStokes")
+complex_only = ("ComplexPoisson",)
+
+
+def _entity_sizes(form: ufl.Form, integral_type: str) -> dict[str, int]:
+    """Sizes of the per-entity kernel arguments.
+
+    The sizes are upper bounds of the strides used by the batched
+    kernel, as coefficients that vanish from an integral are not
+    excluded.
+    """
+    width = 2 if integral_type == "interior_facet" else 1
+    arguments = form.arguments()
+    coefficients = form.coefficients()
+
+    def dim(f):
+        element = f.ufl_function_space().ufl_element()
+        return element.dim + element.num_global_support_dofs
+
+    coordinate_element = form.ufl_domain().ufl_coordinate_element()
+    num_nodes = coordinate_element.dim // coordinate_element.block_size
+    return {
+        "A": int(np.prod([width * dim(v) for v in arguments], dtype=int)),
+        "w": width * sum(dim(f) for f in coefficients),
+        "c": sum(int(np.prod(c.ufl_shape, dtype=int)) for c in form.constants()),
+        "coordinate_dofs": width * num_nodes * 3,
+        "entity_local_index": {"cell": 0, "exterior_facet": 1, "interior_facet": 2}[integral_type],
+    }
+
+
+def _time_kernel(module, integral, form, integral_type, dtype, num_cells, repeats, rng):
+    """Best time (seconds) of the batched kernel over num_cells cells."""
+    ffi = module.ffi
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+    sizes = _entity_sizes(form, integral_type)
+
+    A = np.zeros(num_cells * sizes["A"], dtype=dtype)
+    w = rng.random(num_cells * sizes["w"]).astype(dtype)
+    c = rng.random(sizes["c"]).astype(dtype)
+    coordinate_dofs = rng.random(num_cells * sizes["coordinate_dofs"]).astype(xdtype)
+    entity_local_index = np.zeros(max(num_cells * sizes["entity_local_index"], 1), dtype=np.intc)
+    quadrature_permutation = np.zeros(2 * num_cells, dtype=np.uint8)
+
+    kernel = getattr(integral, f"tabulate_tensor_batch_{np.dtype(dtype).name}")
+    args = (
+        ffi.cast(f"{c_type} *", A.ctypes.data),
+        ffi.cast(f"{c_type} *", w.ctypes.data),
+        ffi.cast(f"{c_type} *", c.ctypes.data),
+        ffi.cast(f"{c_xtype} *", coordinate_dofs.ctypes.data),
+        ffi.cast("int *", entity_local_index.ctypes.data),
+        ffi.cast("uint8_t *", quadrature_permutation.ctypes.data),
+        num_cells,
+        ffi.NULL,
+    )
+
+    # Warm up
+    kernel(*args)
+    best = np.inf
+    for _ in range(repeats):
+        t0 = time.perf_counter()
+        kernel(*args)
+        best = min(best, time.perf_counter() - t0)
+    return best
+
+
+def bench_demo(name, scalar_type, sum_factorization, num_cells, repeats, compile_args):
+    """Benchmark the integrals of the forms of a demo."""
+    ufd = ufl.algorithms.load_ufl_file(str(demo_dir.joinpath(name + ".py")))
+    options = {"scalar_type": scalar_type, "sum_factorization": sum_factorization}
+    results = []
+    rng = np.random.default_rng(0)
+    for form_index, form in enumerate(ufd.forms):
+        entry = {
+            "demo": name,
+            "form": form_index,
+            "scalar_type": scalar_type,
+            "sum_factorization": sum_factorization,
+        }
+        with tempfile.TemporaryDirectory() as cache_dir:
+            t0 = time.perf_counter()
+            try:
+                compiled_forms, module, _ = ffcx.codegeneration.jit.compile_forms(
+                    [form],
+                    options=options,
+                    cache_dir=cache_dir,
+                    cffi_extra_compile_args=compile_args,
+                )
+            except Exception as e:
+                results.append({**entry, "error": f"{type(e).__name__}: {e}"})
+                continue
+            compile_time = time.perf_counter() - t0
+
+            compiled_form = compiled_forms[0]
+            offsets = compiled_form.form_integral_offsets
+            for type_index, integral_type in enumerate(integral_types):
+                for i in range(offsets[type_index], offsets[type_index + 1]):
+                    integral = compiled_form.form_integrals[i]
+                    entry_integral = {
+                        **entry,
+                        "integral_type": integral_type,
+                        "integral": i - offsets[type_index],
+                        "compile_time": compile_time,
+                    }
+                    try:
+                        t = _time_kernel(
+                            module,
+                            integral,
+                            form,
+                            integral_type,
+                            scalar_type,
+                            num_cells,
+                            repeats,
+                            rng,
+                        )
+                    except Exception as e:
+                        results.append({**entry_integral, "error": f"{type(e).__name__}: {e}"})
+                        continue
+                    results.append(
+                        {
+                            **entry_integral,
+                            "num_cells": num_cells,
+                            "time": t,
+                            "cells_per_second": num_cells / t,
+                            "gflops": integral.flops_per_call * num_cells / t * 1e-9,
+                            "flops_per_call": integral.flops_per_call,
+                            "bytes_per_call": integral.bytes_per_call,
+                        }
+                    )
+    return results
+
+
+def _commit():
+    """Commit of the source tree, or None if not in a git checkout."""
+    try:
+        return subprocess.run(
+            ["git", "rev-parse", "HEAD"],
+            cwd=demo_dir,
+            capture_output=True,
+            text=True,
+            check=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main(args=None):
+    """Run the benchmarks."""
+    demos = sorted(f.stem for f in demo_dir.glob("*.py") if f.name != "test_demos.py")
+
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--demo", nargs="+", default=demos, help="demos to benchmark")
+    parser.add_argument(
+        "--scalar-type",
+        nargs="+",
+        default=["float32", "float64", "complex64", "complex128"],
+        help="scalar types",
+    )
+    parser.add_argument(
+        "--sum-factorization",
+        choices=["off", "on", "both"],
+        default="both",
+        help="benchmark with and/or without sum factorization",
+    )
+    parser.add_argument("--num-cells", type=int, default=10000, help="cells per kernel call")
+    parser.add_argument("--repeats", type=int, default=5, help="timed calls, the best is reported")
+    parser.add_argument(
+        "--cflags", default="-O2", help="C compiler flags for the generated code (quoted)"
+    )
+    parser.add_argument("-o", "--output", default="ffcx_bench.json", help="output JSON file")
+    xargs = parser.parse_args(args)
+
+    sum_factorization = {"off": [False], "on": [True], "both": [False, True]}
+    compile_args = xargs.cflags.split()
+
+    results = []
+    for name in xargs.demo:
+        for scalar_type in xargs.scalar_type:
+            if "complex" in scalar_type and name in real_only:
+                continue
+            if "complex" not in scalar_type and name in complex_only:
+                continue
+            for sf in sum_factorization[xargs.sum_factorization]:
+                print(f"{name} {scalar_type} sum_factorization={sf}", flush=True)
+                results += bench_demo(
+                    name, scalar_type, sf, xargs.num_cells, xargs.repeats, compile_args
+                )
+
+    output = {
+        "commit": _commit(),
+        "ffcx_version": ffcx.__version__,
+        "machine": platform.machine(),
+        "processor": platform.processor(),
+        "python": platform.python_version(),
+        "cflags": compile_args,
+        "results": results,
+    }
+    with open(xargs.output, "w") as f:
+        json.dump(output, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -49,12 +49,18 @@ def analyze_ufl_objects(
         ]
     ],
     scalar_type: npt.DTypeLike,
+    constant_values: dict[ufl.Constant, npt.ArrayLike] | None = None,
+    geometry_kernels: bool = False,
 ) -> UFLData:
     """Analyze ufl object(s).
 
     Args:
         ufl_objects: UFL objects
         scalar_type: Scalar type that should be used for the analysis
+        constant_values: Known values of Constants, folded into the
+            integrands of the forms
+        geometry_kernels: Keep detJ and K of forms over affine simplex
+            meshes, to be read from the precomputed geometry
 
     Returns:
         A data structure holding:
@@ -93,7 +99,9 @@ def analyze_ufl_objects(
         else:
             raise TypeError("UFL objects not recognised.")
 
-    form_data = tuple(_analyze_form(form, scalar_type) for form in forms)
+    form_data = tuple(
+        _analyze_form(form, scalar_type, constant_values, geometry_kernels) for form in forms
+    )
     for data in form_data:
         elements += data.unique_sub_elements
         coordinate_elements += data.coordinate_elements
@@ -149,13 +157,19 @@ def _analyze_expression(
 
 
 def _analyze_form(
-    form: ufl.form.Form, scalar_type: npt.DTypeLike
+    form: ufl.form.Form,
+    scalar_type: npt.DTypeLike,
+    constant_values: dict[ufl.Constant, npt.ArrayLike] | None = None,
+    geometry_kernels: bool = False,
 ) -> ufl.algorithms.formdata.FormData:
     """Analyzes UFL form and attaches metadata.
 
     Args:
         form: forms
         scalar_type: Scalar type used for form. This is used to simplify real valued forms
+        constant_values: Known values of Constants, folded into the integrands
+        geometry_kernels: Keep detJ and K on affine simplex meshes instead of
+            lowering them to expressions of J
 
     Returns:
         Form data computed by UFL with metadata attached
@@ -178,18 +192,29 @@ def _analyze_form(
     # Check for complex mode
     complex_mode = np.issubdtype(scalar_type, np.complexfloating)
 
+    # detJ and K are constant on affine simplex meshes, and the geometry
+    # kernels read them from the precomputed geometry
+    preserve_geometry_types: tuple[type, ...] = (ufl.classes.Jacobian,)
+    if geometry_kernels and all(
+        domain.is_piecewise_linear_simplex_domain() for domain in form.ufl_domains()
+    ):
+        preserve_geometry_types += (ufl.classes.JacobianDeterminant, ufl.classes.JacobianInverse)
+
     # Compute form metadata
     form_data: ufl.algorithms.formdata.FormData = ufl.algorithms.compute_form_data(
         form,
         do_apply_function_pullbacks=True,
         do_apply_integral_scaling=True,
         do_apply_geometry_lowering=True,
-        preserve_geometry_types=(ufl.classes.Jacobian,),
+        preserve_geometry_types=preserve_geometry_types,
         do_apply_restrictions=True,
         do_append_everywhere_integrals=False,  # do not add dx integrals to dx(i) in UFL
         complex_mode=complex_mode,
     )
 
+    if constant_values:
+        _fold_constants(form_data, constant_values)
+
     # Determine unique quadrature degree and quadrature scheme
     # per each integral data
     for id, integral_data in enumerate(form_data.integral_data):
@@ -222,7 +247,8 @@ def _analyze_form(
 
                 # Sending in a negative quadrature degree means that we want to be
                 # able to customize it at a later stage.
-                if qd < 0:
+                estimated = qd < 0
+                if estimated:
                     qd = np.max(integral.metadata()["estimated_polynomial_degree"])
 
                 # Extract quadrature rule
@@ -232,7 +258,13 @@ def _analyze_form(
                 logger.info(f"--- quadrature rule: {qr}")
                 logger.info(f"--- quadrature degree: {qd}")
 
-                metadata.update({"quadrature_degree": qd, "quadrature_rule": qr})
+                metadata.update(
+                    {
+                        "quadrature_degree": qd,
+                        "quadrature_rule": qr,
+                        "estimated_quadrature_degree": estimated,
+                    }
+                )
             else:
                 metadata.update(
                     {
@@ -247,6 +279,45 @@ def _analyze_form(
     return form_data
 
 
+def _fold_constants(
+    form_data: ufl.algorithms.formdata.FormData,
+    constant_values: dict[ufl.Constant, npt.ArrayLike],
+) -> None:
+    """Replace Constants with known values by literals in the integrands.
+
+    UFL simplifies the integrands as they are rebuilt, so that terms
+    multiplied by a zero Constant vanish. Integrals which vanish entirely
+    are removed. The Constants of the original form, and so the layout
+    of the constants passed to the kernels, are unchanged.
+    """
+    mapping = {}
+    for constant in form_data.original_form.constants():
+        if constant not in constant_values:
+            continue
+        value = np.asarray(constant_values[constant])
+        if value.shape != constant.ufl_shape:
+            raise ValueError(
+                f"Value of shape {value.shape} given for Constant of shape {constant.ufl_shape}."
+            )
+        if value.shape:
+            mapping[constant] = ufl.as_tensor(value.tolist())
+        else:
+            mapping[constant] = ufl.as_ufl(value.item())
+
+    if not mapping:
+        return
+
+    for integral_data in form_data.integral_data:
+        integrals = [
+            integral.reconstruct(integrand=ufl.replace(integral.integrand(), mapping))
+            for integral in integral_data.integrals
+        ]
+        integral_data.integrals[:] = [
+            itg for itg in integrals if not isinstance(itg.integrand(), ufl.classes.Zero)
+        ]
+    form_data.integral_data[:] = [d for d in form_data.integral_data if d.integrals]
+
+
 def _has_custom_integrals(
     o: typing.Union[ufl.integral.Integral, ufl.classes.Form, list, tuple],  # type: ignore
 ) -> bool:
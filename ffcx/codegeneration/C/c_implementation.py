@@ -5,12 +5,14 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 """C implementation."""
 
+import typing
 import warnings
 
 import numpy as np
 import numpy.typing as npt
 
 import ffcx.codegeneration.lnodes as L
+from ffcx.codegeneration.optimizer import is_vectorisable_loop
 from ffcx.codegeneration.utils import dtype_to_c_type, dtype_to_scalar_dtype
 
 math_table = {
@@ -147,11 +149,38 @@ class CFormatter:
 
     scalar_type: np.dtype
     real_type: np.dtype
-
-    def __init__(self, dtype: npt.DTypeLike) -> None:
-        """Initialise."""
+    table_type: np.dtype
+
+    def __init__(
+        self,
+        dtype: npt.DTypeLike,
+        real_dtype: typing.Optional[npt.DTypeLike] = None,
+        alignment: int = 0,
+        simd_hints: bool = False,
+        table_dtype: typing.Optional[npt.DTypeLike] = None,
+    ) -> None:
+        """Initialise.
+
+        Args:
+            dtype: Type of scalar (L.DataType.SCALAR) variables.
+            real_dtype: Type of real (L.DataType.REAL) variables, the
+                real type of dtype if None.
+            alignment: Alignment in bytes of scalar and real arrays, 0
+                for natural alignment. The innermost dimension of static
+                tables is padded with zeros to a multiple of it.
+            simd_hints: Mark innermost loops without loop-carried
+                dependencies with ``FFCX_SIMD`` (see `simd_preamble`).
+            table_dtype: Type of static tables (L.DataType.TABLE), the
+                real type of dtype if None.
+        """
         self.scalar_type = np.dtype(dtype)
-        self.real_type = dtype_to_scalar_dtype(dtype)
+        self.real_type = dtype_to_scalar_dtype(dtype if real_dtype is None else real_dtype)
+        self.table_type = dtype_to_scalar_dtype(dtype if table_dtype is None else table_dtype)
+        self.alignment = alignment
+        self.simd_hints = simd_hints
+        # Arrays whose entries are added to with FFCX_ATOMIC (see
+        # atomic_preamble), e.g. the global values of scatter kernels
+        self.atomic_arrays: set[str] = set()
 
     def _dtype_to_name(self, dtype) -> str:
         """Convert dtype to C name."""
@@ -159,6 +188,8 @@ class CFormatter:
             return dtype_to_c_type(self.scalar_type)
         if dtype == L.DataType.REAL:
             return dtype_to_c_type(self.real_type)
+        if dtype == L.DataType.TABLE:
+            return dtype_to_c_type(self.table_type)
         if dtype == L.DataType.INT:
             return "int"
         if dtype == L.DataType.BOOL:
@@ -184,9 +215,13 @@ class CFormatter:
         arr += "}"
         return arr
 
+    def format_statements(self, statements) -> str:
+        """Format a sequence of statements."""
+        return "".join(self.c_format(s) for s in statements)
+
     def format_statement_list(self, slist) -> str:
         """Format a statement list."""
-        return "".join(self.c_format(s) for s in slist.statements)
+        return self.format_statements(slist.statements)
 
     def format_section(self, section) -> str:
         """Format a section."""
@@ -197,12 +232,12 @@ class CFormatter:
             f"// Inputs: {', '.join(w.name for w in section.input)}\n"
             f"// Outputs: {', '.join(w.name for w in section.output)}\n"
         )
-        declarations = "".join(self.c_format(s) for s in section.declarations)
+        declarations = self.format_statements(section.declarations)
 
         body = ""
         if len(section.statements) > 0:
             declarations += "{\n  "
-            body = "".join(self.c_format(s) for s in section.statements)
+            body = self.format_statements(section.statements)
             body = body.replace("\n", "\n  ")
             body = body[:-2] + "}\n"
 
@@ -213,18 +248,45 @@ class CFormatter:
         """Format a comment."""
         return "// " + c.comment + "\n"
 
+    def _padded_values(self, arr):
+        """Sizes and values of an array, padded for the alignment."""
+        values = arr.values
+        if (
+            self.alignment == 0
+            or not arr.const
+            or arr.symbol.dtype not in (L.DataType.SCALAR, L.DataType.REAL, L.DataType.TABLE)
+            or values.shape != arr.sizes
+            or len(arr.sizes) == 0
+        ):
+            return arr.sizes, values
+        dtype = {
+            L.DataType.SCALAR: self.scalar_type,
+            L.DataType.REAL: self.real_type,
+            L.DataType.TABLE: self.table_type,
+        }[arr.symbol.dtype]
+        lanes = max(self.alignment // dtype.itemsize, 1)
+        padding = -arr.sizes[-1] % lanes
+        if padding == 0:
+            return arr.sizes, values
+        values = np.pad(values, [(0, 0)] * (values.ndim - 1) + [(0, padding)])
+        return values.shape, values
+
     def format_array_decl(self, arr) -> str:
         """Format an array declaration."""
         dtype = arr.symbol.dtype
         typename = self._dtype_to_name(dtype)
+        if self.alignment > 0 and dtype in (L.DataType.SCALAR, L.DataType.REAL, L.DataType.TABLE):
+            typename = f"alignas({self.alignment}) {typename}"
 
         symbol = self.c_format(arr.symbol)
-        dims = "".join([f"[{i}]" for i in arr.sizes])
         if arr.values is None:
             assert arr.const is False
+            dims = "".join([f"[{i}]" for i in arr.sizes])
             return f"{typename} {symbol}{dims};\n"
 
-        vals = self._build_initializer_lists(arr.values)
+        sizes, values = self._padded_values(arr)
+        dims = "".join([f"[{i}]" for i in sizes])
+        vals = self._build_initializer_lists(values)
         cstr = "static const " if arr.const else ""
         return f"{cstr}{typename} {symbol}{dims} = {vals};\n"
 
@@ -290,7 +352,10 @@ class CFormatter:
         begin = self.c_format(r.begin)
         end = self.c_format(r.end)
         index = self.c_format(r.index)
-        output = f"for (int {index} = {begin}; {index} < {end}; ++{index})\n"
+        output = ""
+        if self.simd_hints and is_vectorisable_loop(r):
+            output += "FFCX_SIMD\n"
+        output += f"for (int {index} = {begin}; {index} < {end}; ++{index})\n"
         output += "{\n"
         body = self.c_format(r.body)
         for line in body.split("\n"):
@@ -307,6 +372,12 @@ class CFormatter:
         """Format an assignment."""
         rhs = self.c_format(expr.rhs)
         lhs = self.c_format(expr.lhs)
+        if (
+            isinstance(expr, L.AssignAdd)
+            and isinstance(expr.lhs, L.ArrayAccess)
+            and expr.lhs.array.name in self.atomic_arrays
+        ):
+            return f"FFCX_ATOMIC\n{lhs} {expr.op} {rhs};\n"
         return f"{lhs} {expr.op} {rhs};\n"
 
     def format_conditional(self, s) -> str:
@@ -342,6 +413,8 @@ class CFormatter:
         if hasattr(c.args[0], "dtype"):
             if c.args[0].dtype == L.DataType.REAL:
                 arg_type = self.real_type
+            elif c.args[0].dtype == L.DataType.TABLE:
+                arg_type = self.table_type
         else:
             warnings.warn(f"Syntax item without dtype {c.args[0]}")
 
@@ -394,3 +467,393 @@ class CFormatter:
             return self.c_impl[name](self, s)
         except KeyError:
             raise RuntimeError("Unknown statement: ", name)
+
+
+# Definition of the loop hint used by kernels generated with the
+# simd_hints option: an OpenMP SIMD directive when OpenMP (or only its
+# SIMD directives, with FFCX_OPENMP_SIMD defined) is enabled, and
+# otherwise the equivalent compiler-specific pragma.
+simd_preamble = """
+#if defined(_OPENMP) || defined(FFCX_OPENMP_SIMD)
+#define FFCX_SIMD _Pragma("omp simd")
+#elif defined(__clang__)
+#define FFCX_SIMD _Pragma("clang loop vectorize(enable)")
+#elif defined(__GNUC__)
+#define FFCX_SIMD _Pragma("GCC ivdep")
+#else
+#define FFCX_SIMD
+#endif
+"""
+
+
+# Definition of the atomic update of the entries of the global values
+# by the kernels generated with the scatter_kernels option: an OpenMP
+# atomic directive when OpenMP is enabled, unless FFCX_NO_ATOMIC is
+# defined for assemblers colouring the cells. OpenMP has no atomic
+# update of complex numbers.
+atomic_preamble = """
+#if defined(_OPENMP) && !defined(FFCX_NO_ATOMIC)
+#define FFCX_ATOMIC _Pragma("omp atomic")
+#else
+#define FFCX_ATOMIC
+#endif
+"""
+
+complex_atomic_preamble = """
+#define FFCX_ATOMIC
+"""
+
+
+# Math functions available for vector-extension types in the
+# cell-batched kernels, by number of arguments. Other functions
+# (e.g. Bessel functions) are not supported in the cell-batched mode.
+vector_math_functions = {
+    1: (
+        "sqrt",
+        "abs",
+        "cos",
+        "sin",
+        "tan",
+        "acos",
+        "asin",
+        "atan",
+        "cosh",
+        "sinh",
+        "tanh",
+        "acosh",
+        "asinh",
+        "atanh",
+        "exp",
+        "ln",
+        "erf",
+    ),
+    2: ("power", "atan_2", "min_value", "max_value"),
+}
+
+
+def vector_type_name(dtype: npt.DTypeLike) -> str:
+    """Name of the vector-extension type used by the cell-batched kernels."""
+    return f"ffcx_vec_{np.dtype(dtype).name}"
+
+
+def vector_preamble(dtype: npt.DTypeLike, width: int) -> str:
+    """Vector type and lane-wise math macros for the cell-batched kernels.
+
+    The macros use statement expressions rather than inline functions, as
+    passing vector types by value triggers ABI warnings on some targets.
+    """
+    scalar_type = np.dtype(dtype)
+    c_type = dtype_to_c_type(scalar_type)
+    vtype = vector_type_name(scalar_type)
+    code = [
+        f"typedef {c_type} {vtype} __attribute__"
+        f"((vector_size({width * scalar_type.itemsize}), aligned({scalar_type.itemsize})));"
+    ]
+    for function in vector_math_functions[1]:
+        f = math_table[scalar_type.name][function]
+        code += [
+            f"#define {vtype}_{f}(x) ({{ {vtype} r_ = (x); "
+            f"for (int l_ = 0; l_ < {width}; ++l_) r_[l_] = {f}(r_[l_]); r_; }})"
+        ]
+    for function in vector_math_functions[2]:
+        f = math_table[scalar_type.name][function]
+        code += [
+            f"#define {vtype}_{f}(x, y) ({{ {vtype} r_ = ({vtype}){{}} + (x); "
+            f"{vtype} s_ = ({vtype}){{}} + (y); "
+            f"for (int l_ = 0; l_ < {width}; ++l_) r_[l_] = {f}(r_[l_], s_[l_]); r_; }})"
+        ]
+    return "\n".join(code) + "\n"
+
+
+class CVectorFormatter(CFormatter):
+    """C formatter for cell-batched kernels using vector-extension types.
+
+    Each scalar or real variable in the kernel holds the values for
+    `width` cells, using the GCC/Clang vector extensions. Static tables
+    and constants remain scalar and are broadcast by the compiler.
+    """
+
+    def __init__(self, dtype: npt.DTypeLike, width: int, arguments: list[str]) -> None:
+        """Initialise.
+
+        Args:
+            dtype: Scalar type of the kernel. Only real types are supported.
+            width: Number of cells per kernel call.
+            arguments: Names of the kernel arguments holding per-cell data.
+        """
+        super().__init__(dtype)
+        if np.issubdtype(self.scalar_type, np.complexfloating):
+            raise NotImplementedError("Cell-batched kernels are not available for complex types.")
+        if width < 2 or width & (width - 1) != 0:
+            raise ValueError(f"Cell batch size must be a power of two, got {width}.")
+        self.width = width
+        self.vtype = vector_type_name(self.scalar_type)
+        self.arguments = set(arguments)
+        self.vector_symbols = set(arguments)
+        self.used_arguments: set[str] = set()
+
+    def _is_vector(self, expr) -> bool:
+        """Check if an expression holds per-cell (vector) values."""
+        if isinstance(expr, L.Symbol):
+            return expr.name in self.vector_symbols
+        if isinstance(expr, L.ArrayAccess):
+            return expr.array.name in self.vector_symbols
+        if isinstance(expr, (L.LiteralFloat, L.LiteralInt, L.MultiIndex)):
+            return False
+        if isinstance(expr, L.Conditional):
+            operands = [expr.condition, expr.true, expr.false]
+        elif isinstance(expr, L.BinOp):
+            operands = [expr.lhs, expr.rhs]
+        elif isinstance(expr, L.PrefixUnaryOp):
+            operands = [expr.arg]
+        elif isinstance(expr, (L.NaryOp, L.MathFunction)):
+            operands = expr.args
+        else:
+            raise NotImplementedError(f"Unsupported expression in cell-batched kernel: {expr}")
+        return any(self._is_vector(op) for op in operands)
+
+    def _broadcast(self, expr) -> str:
+        """Format an expression, broadcasting it to a vector if needed."""
+        value = self.c_format(expr)
+        if self._is_vector(expr):
+            return value
+        return f"({self.vtype}){{}} + ({value})"
+
+    def format_array_decl(self, arr) -> str:
+        """Format an array declaration."""
+        if arr.const or arr.symbol.dtype not in (L.DataType.SCALAR, L.DataType.REAL):
+            return super().format_array_decl(arr)
+        assert arr.values is None or np.all(arr.values == 0)
+        self.vector_symbols.add(arr.symbol.name)
+        symbol = self.c_format(arr.symbol)
+        dims = "".join([f"[{i}]" for i in arr.sizes])
+        init = "" if arr.values is None else " = {0}"
+        return f"{self.vtype} {symbol}{dims}{init};\n"
+
+    def format_variable_decl(self, v) -> str:
+        """Format a variable declaration."""
+        if v.symbol.dtype not in (L.DataType.SCALAR, L.DataType.REAL):
+            return super().format_variable_decl(v)
+        val = self._broadcast(v.value)
+        self.vector_symbols.add(v.symbol.name)
+        symbol = self.c_format(v.symbol)
+        return f"{self.vtype} {symbol} = {val};\n"
+
+    def format_literal_float(self, val) -> str:
+        """Format a literal float."""
+        value = self._format_number(val.value)
+        if self.real_type == np.float32:
+            # Avoid implicit double to float vector conversion, which is an error
+            return f"(({dtype_to_c_type(self.real_type)}){value})"
+        return value
+
+    def format_symbol(self, s) -> str:
+        """Format a symbol."""
+        if s.name in self.arguments:
+            self.used_arguments.add(s.name)
+        return super().format_symbol(s)
+
+    def format_scalar_only(self, oper) -> str:
+        """Format an operation which is not supported on vectors."""
+        if self._is_vector(oper):
+            raise NotImplementedError(
+                f"Operation {type(oper).__name__} is not supported in cell-batched kernels."
+            )
+        return CFormatter.c_impl[oper.__class__.__name__](self, oper)
+
+    def format_math_function(self, c) -> str:
+        """Format a mathematical function."""
+        if not self._is_vector(c):
+            return super().format_math_function(c)
+        if c.function not in vector_math_functions.get(len(c.args), ()):
+            raise NotImplementedError(
+                f"Math function {c.function} is not supported in cell-batched kernels."
+            )
+        func = math_table[self.scalar_type.name][c.function]
+        args = ", ".join(self.c_format(arg) for arg in c.args)
+        return f"{self.vtype}_{func}({args})"
+
+    c_impl = {
+        **CFormatter.c_impl,
+        "ArrayDecl": format_array_decl,
+        "VariableDecl": format_variable_decl,
+        "LiteralFloat": format_literal_float,
+        "Symbol": format_symbol,
+        "MathFunction": format_math_function,
+        "Conditional": format_scalar_only,
+        "Not": format_scalar_only,
+        "And": format_scalar_only,
+        "Or": format_scalar_only,
+        "NE": format_scalar_only,
+        "EQ": format_scalar_only,
+        "GE": format_scalar_only,
+        "LE": format_scalar_only,
+        "GT": format_scalar_only,
+        "LT": format_scalar_only,
+    }
+
+
+class CBlockFormatter(CFormatter):
+    """C formatter for kernels tabulating a block of cells per pass.
+
+    Each per-cell variable in the kernel is an array holding the values
+    for the cells of the block, and each run of statements computing
+    per-cell values is wrapped in a loop over the cells of the block.
+    The loops over quadrature points and basis functions enclose the
+    cell loops, so the table entries are loaded once for all cells of
+    the block. The kernel body is formatted for a loop over the blocks,
+    in which ``block`` is the first and ``block_cells`` the number of
+    cells of the block.
+    """
+
+    def __init__(
+        self,
+        dtype: npt.DTypeLike,
+        real_dtype: typing.Optional[npt.DTypeLike],
+        alignment: int,
+        simd_hints: bool,
+        table_dtype: typing.Optional[npt.DTypeLike],
+        block_size: int,
+        arguments: dict[str, int],
+    ) -> None:
+        """Initialise.
+
+        Args:
+            dtype: Type of scalar (L.DataType.SCALAR) variables.
+            real_dtype: Type of real (L.DataType.REAL) variables.
+            alignment: Alignment in bytes of scalar and real arrays.
+            simd_hints: Mark the cell loops with ``FFCX_SIMD``.
+            table_dtype: Type of static tables (L.DataType.TABLE).
+            block_size: Maximum number of cells per block.
+            arguments: Sizes of the kernel arguments per cell, by name.
+                The arguments of size 0 are shared by all cells.
+        """
+        super().__init__(dtype, real_dtype, alignment, False, table_dtype)
+        if block_size < 2:
+            raise ValueError(f"Block size must be at least 2, got {block_size}.")
+        self.block_size = block_size
+        self.cell_simd_hints = simd_hints
+        self.arguments = {name: size for name, size in arguments.items() if size > 0}
+        self.block_symbols = set(self.arguments)
+        self.in_cell_loop = False
+
+    def _is_block(self, expr) -> bool:
+        """Check if an expression holds per-cell values."""
+        if isinstance(expr, L.Symbol):
+            return expr.name in self.block_symbols
+        if isinstance(expr, L.ArrayAccess):
+            return expr.array.name in self.block_symbols or any(
+                self._is_block(i) for i in expr.indices
+            )
+        if isinstance(expr, (L.LiteralFloat, L.LiteralInt, L.MultiIndex)):
+            return False
+        if isinstance(expr, L.Conditional):
+            operands = [expr.condition, expr.true, expr.false]
+        elif isinstance(expr, L.BinOp):
+            operands = [expr.lhs, expr.rhs]
+        elif isinstance(expr, L.PrefixUnaryOp):
+            operands = [expr.arg]
+        elif isinstance(expr, (L.NaryOp, L.MathFunction)):
+            operands = expr.args
+        else:
+            raise NotImplementedError(f"Unsupported expression in blocked kernel: {expr}")
+        return any(self._is_block(op) for op in operands)
+
+    def _is_block_statement(self, s) -> bool:
+        """Check if a statement computes per-cell values, in the cell loop."""
+        if isinstance(s, L.VariableDecl):
+            return self._is_block(s.value)
+        if type(s) is not L.Statement or not self._is_block(s.expr):
+            return False
+        if isinstance(s.expr, L.AssignOp) and not self._is_block(s.expr.lhs):
+            raise NotImplementedError(
+                f"Assignment of per-cell values to shared variable {s.expr.lhs}."
+            )
+        return True
+
+    def format_statements(self, statements) -> str:
+        """Format a sequence of statements, grouping the per-cell statements in cell loops."""
+        output = ""
+        run: list = []
+        for s in statements:
+            if self._is_block_statement(s):
+                if isinstance(s, L.VariableDecl):
+                    self.block_symbols.add(s.symbol.name)
+                run.append(s)
+            else:
+                output += self._format_cell_loop(run)
+                output += self.c_format(s)
+                run = []
+        return output + self._format_cell_loop(run)
+
+    def _format_cell_loop(self, run: list) -> str:
+        """Format a loop over the cells of the block, declaring the variables it defines."""
+        if len(run) == 0:
+            return ""
+        declarations = ""
+        body = ""
+        self.in_cell_loop = True
+        for s in run:
+            if isinstance(s, L.VariableDecl):
+                typename = self._dtype_to_name(s.symbol.dtype)
+                if self.alignment > 0:
+                    typename = f"alignas({self.alignment}) {typename}"
+                declarations += f"{typename} {s.symbol.name}[{self.block_size}];\n"
+                body += f"{s.symbol.name}[cell] = {self.c_format(s.value)};\n"
+            else:
+                body += self.c_format(s)
+        self.in_cell_loop = False
+
+        output = declarations
+        if self.cell_simd_hints:
+            output += "FFCX_SIMD\n"
+        output += "for (int cell = 0; cell < block_cells; ++cell)\n{\n"
+        for line in body.split("\n"):
+            if len(line) > 0:
+                output += f"  {line}\n"
+        return output + "}\n"
+
+    def format_array_decl(self, arr) -> str:
+        """Format an array declaration, with the cells of the block as innermost dimension."""
+        if arr.const or arr.symbol.dtype not in (L.DataType.SCALAR, L.DataType.REAL):
+            return super().format_array_decl(arr)
+        if arr.values is not None and not np.all(arr.values == 0):
+            raise NotImplementedError(f"Initialised local array {arr.symbol.name}.")
+        self.block_symbols.add(arr.symbol.name)
+        typename = self._dtype_to_name(arr.symbol.dtype)
+        if self.alignment > 0:
+            typename = f"alignas({self.alignment}) {typename}"
+        dims = "".join([f"[{i}]" for i in arr.sizes]) + f"[{self.block_size}]"
+        init = "" if arr.values is None else " = {0}"
+        return f"{typename} {arr.symbol.name}{dims}{init};\n"
+
+    def format_array_access(self, arr) -> str:
+        """Format an array access, of the current cell for per-cell arrays."""
+        name = arr.array.name
+        if name in self.arguments:
+            if len(arr.indices) != 1:
+                raise NotImplementedError(f"Multi-dimensional access of argument {name}.")
+            index = self.c_format(arr.indices[0])
+            if arr.indices[0].precedence >= L.PRECEDENCE.ADD:
+                index = f"({index})"
+            return f"{name}[(block + cell) * {self.arguments[name]} + {index}]"
+        indices = "".join(f"[{self.c_format(i)}]" for i in arr.indices)
+        if name in self.block_symbols:
+            return f"{name}{indices}[cell]"
+        return f"{name}{indices}"
+
+    def format_symbol(self, s) -> str:
+        """Format a symbol, of the current cell for per-cell variables."""
+        if s.name in self.arguments:
+            raise NotImplementedError(f"Unsupported use of argument {s.name} in blocked kernel.")
+        if s.name in self.block_symbols:
+            assert self.in_cell_loop
+            return f"{s.name}[cell]"
+        return super().format_symbol(s)
+
+    c_impl = {
+        **CFormatter.c_impl,
+        "ArrayDecl": format_array_decl,
+        "ArrayAccess": format_array_access,
+        "Symbol": format_symbol,
+    }
@@ -8,15 +8,22 @@
 from __future__ import annotations
 
 import logging
+import re
+import textwrap
 import typing
 
 import numpy as np
 
+from ffcx import profiling
 from ffcx.codegeneration.backend import FFCXBackend
 from ffcx.codegeneration.C import expressions_template
 from ffcx.codegeneration.C.c_implementation import CFormatter
 from ffcx.codegeneration.expression_generator import ExpressionGenerator
-from ffcx.codegeneration.utils import dtype_to_c_type, dtype_to_scalar_dtype
+from ffcx.codegeneration.utils import (
+    dtype_to_c_type,
+    dtype_to_scalar_dtype,
+    dtype_with_precision,
+)
 from ffcx.ir.representation import ExpressionIR
 
 logger = logging.getLogger("ffcx")
@@ -42,10 +49,48 @@ def generator(ir: ExpressionIR, options):
     d: dict[str, typing.Union[str, int]] = {}
     d["name_from_uflfile"] = ir.name_from_uflfile
     d["factory_name"] = factory_name
-    parts = eg.generate()
-
-    CF = CFormatter(options["scalar_type"])
-    d["tabulate_expression"] = CF.c_format(parts)
+    # Tables are stored in the compute precision, as in integral kernels
+    table_dtype = dtype_with_precision(options["scalar_type"], options["compute_precision"])
+    with profiling.scope(factory_name):
+        parts = eg.generate()
+
+        with profiling.timer("c_format"):
+            CF = CFormatter(
+                options["scalar_type"],
+                alignment=options["table_alignment"],
+                simd_hints=options["simd_hints"],
+                table_dtype=table_dtype,
+            )
+            d["tabulate_expression"] = CF.c_format(parts)
+
+        # Batched kernel, with the tables declared once for all cells,
+        # generated with cell batching only as for integrals
+        d["batch_kernel"] = ""
+        d["tabulate_tensor_batch"] = ""
+        if options["cell_batch_size"] > 1:
+            eg = ExpressionGenerator(ir, FFCXBackend(ir, options))
+            tables, body = eg.generate_batch()
+            with profiling.timer("c_format"):
+                CF = CFormatter(
+                    options["scalar_type"],
+                    alignment=options["table_alignment"],
+                    simd_hints=options["simd_hints"],
+                    table_dtype=table_dtype,
+                )
+                batch_tables = CF.c_format(tables)
+                batch_expression = textwrap.indent(CF.c_format(body), "    ")
+            d["batch_kernel"] = expressions_template.batch_kernel.format(
+                factory_name=factory_name,
+                scalar_type=dtype_to_c_type(options["scalar_type"]),
+                geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+                batch_tables=batch_tables,
+                batch_arguments=_batch_arguments(ir, batch_expression, options),
+                batch_expression=batch_expression,
+            )
+            np_scalar_type = np.dtype(options["scalar_type"]).name
+            d["tabulate_tensor_batch"] = (
+                f".tabulate_tensor_batch_{np_scalar_type} = tabulate_tensor_batch_{factory_name},"
+            )
 
     if len(ir.original_coefficient_positions) > 0:
         d["original_coefficient_positions"] = f"original_coefficient_positions_{factory_name}"
@@ -115,4 +160,35 @@ def generator(ir: ExpressionIR, options):
     # Format implementation code
     implementation = expressions_template.factory.format_map(d)
 
+    with profiling.scope(factory_name):
+        profiling.record("code_size", len(implementation))
+
     return declaration, implementation
+
+
+def _batch_arguments(ir: ExpressionIR, body: str, options) -> str:
+    """Declare the arguments of one cell of the batched kernel.
+
+    Each per-cell argument is offset by its size in the single cell
+    kernel, so that the output of cell i starts at A + i * size(A). The
+    cell index is a ptrdiff_t, so the offsets of large batches do not
+    overflow. Only the arguments used by the body are declared.
+    """
+    scalar_type = dtype_to_c_type(options["scalar_type"])
+    geom_type = dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"]))
+    num_points = next(iter(ir.expression.integrand))[1].points.shape[0]
+    tensor_size = num_points * int(
+        np.prod(ir.expression.shape, dtype=int) * np.prod(ir.expression.tensor_shape, dtype=int)
+    )
+    arguments = [
+        (f"{scalar_type}*", "A", tensor_size),
+        (f"const {scalar_type}*", "w", ir.coefficient_size),
+        (f"const {geom_type}*", "coordinate_dofs", ir.coordinate_dofs_size),
+        ("const int*", "entity_local_index", 1),
+        ("const uint8_t*", "quadrature_permutation", 1),
+    ]
+    return "\n".join(
+        f"    {ctype} restrict {name} = {name}_ + cell * {size};"
+        for ctype, name, size in arguments
+        if re.search(rf"\b{name}\b", body)
+    )
@@ -29,6 +29,7 @@ void tabulate_tensor_{factory_name}({scalar_type}* restrict A,
 {tabulate_expression}
 }}
 
+{batch_kernel}
 {points_init}
 {value_shape_init}
 {original_coefficient_positions_init}
@@ -39,6 +40,7 @@ void tabulate_tensor_{factory_name}({scalar_type}* restrict A,
 ufcx_expression {factory_name} =
 {{
   .tabulate_tensor_{np_scalar_type} = tabulate_tensor_{factory_name},
+  {tabulate_tensor_batch}
   .num_coefficients = {num_coefficients},
   .num_constants = {num_constants},
   .original_coefficient_positions = {original_coefficient_positions},
@@ -58,3 +60,22 @@ ufcx_expression* {name_from_uflfile} = &{factory_name};
 
 // End of code for expression {factory_name}
 """
+
+batch_kernel = """
+void tabulate_tensor_batch_{factory_name}({scalar_type}* restrict A_,
+                                          const {scalar_type}* restrict w_,
+                                          const {scalar_type}* restrict c,
+                                          const {geom_type}* restrict coordinate_dofs_,
+                                          const int* restrict entity_local_index_,
+                                          const uint8_t* restrict quadrature_permutation_,
+                                          int num_cells,
+                                          void* custom_data)
+{{
+{batch_tables}
+  for (ptrdiff_t cell = 0; cell < num_cells; ++cell)
+  {{
+{batch_arguments}
+{batch_expression}
+  }}
+}}
+"""
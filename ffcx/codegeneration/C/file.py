@@ -17,6 +17,15 @@ import numpy as np
 from ffcx import __version__ as FFCX_VERSION
 from ffcx.codegeneration import __version__ as UFC_VERSION
 from ffcx.codegeneration.C import file_template
+from ffcx.codegeneration.C.c_implementation import (
+    CFormatter,
+    atomic_preamble,
+    complex_atomic_preamble,
+    simd_preamble,
+    vector_preamble,
+)
+from ffcx.codegeneration.table_pool import TablePool
+from ffcx.codegeneration.utils import dtype_with_precision
 
 logger = logging.getLogger("ffcx")
 
@@ -33,6 +42,27 @@ def generator(options):
         extra_c_includes += ["complex.h"]
     d["extra_c_includes"] = "\n".join(f"#include <{header}>" for header in extra_c_includes)
 
+    # Vector types for the cell-batched kernels
+    d["vector_types"] = ""
+    if options["cell_batch_size"] > 1 and not np.issubdtype(
+        options["scalar_type"], np.complexfloating
+    ):
+        d["vector_types"] = vector_preamble(options["scalar_type"], options["cell_batch_size"])
+
+    # Loop hint of the kernels generated with simd_hints
+    d["simd_hints"] = simd_preamble if options["simd_hints"] else ""
+
+    # Switch of the instruction set specific kernels
+    d["isa_dispatch"] = file_template.isa_dispatch if options["isa_dispatch"] else ""
+
+    # Update of the global values by the scatter kernels
+    d["scatter_atomic"] = ""
+    if options["scatter_kernels"]:
+        if np.issubdtype(options["scalar_type"], np.complexfloating):
+            d["scatter_atomic"] = complex_atomic_preamble
+        else:
+            d["scatter_atomic"] = atomic_preamble
+
     # Format declaration code
     code_pre = (
         file_template.declaration_pre.format_map(d),
@@ -46,3 +76,14 @@ def generator(options):
     )
 
     return code_pre, code_post
+
+
+def table_pool_generator(table_pool: TablePool, options):
+    """Generate the file-scope declarations of the tables in a table pool."""
+    # Tables and quadrature weights are stored in the compute precision
+    table_dtype = dtype_with_precision(options["scalar_type"], options["compute_precision"])
+    CF = CFormatter(table_dtype, alignment=options["table_alignment"], table_dtype=table_dtype)
+    implementation = "".join(CF.c_format(decl) for decl in table_pool.declarations)
+    if implementation:
+        implementation = file_template.table_pool.format(tables=implementation)
+    return "", implementation
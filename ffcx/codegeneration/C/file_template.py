@@ -38,11 +38,41 @@ implementation_pre = """
 
 #include <math.h>
 #include <stdalign.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ufcx.h>
 {extra_c_includes}
+{vector_types}
+{simd_hints}
+{isa_dispatch}
+{scatter_atomic}
+"""
+
+table_pool = """
+// Tables of basis function values and quadrature weights shared by the
+// kernels of this file
+{tables}
+"""
 
+# Definitions of FFCX_ISA_DISPATCH_X86_64 and FFCX_ISA_DISPATCH_AARCH64,
+# enabling the instruction set specific kernels generated with the
+# isa_dispatch option for compilers supporting the target attribute, on
+# x86-64 and on AArch64 Linux. The hardware capability bits are those of
+# the Linux ABI, for C libraries not defining them.
+isa_dispatch = """
+#if defined(__GNUC__) && defined(__x86_64__)
+#define FFCX_ISA_DISPATCH_X86_64
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#define FFCX_ISA_DISPATCH_AARCH64
+#include <sys/auxv.h>
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1UL << 1)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+#endif
 """
 
 if sys.platform.startswith("win32"):
@@ -51,3 +81,28 @@ else:
     libraries: list[str] = ["m"]
 
 implementation_post = ""
+
+cmake_project = """# CMake project building the code generated by FFCx version {ffcx_version}
+# into a library, static or shared with -DBUILD_SHARED_LIBS=ON
+cmake_minimum_required(VERSION 3.19)
+project({name} LANGUAGES C)
+include(GNUInstallDirs)
+
+find_package(ufcx REQUIRED CONFIG)
+
+add_library({name} {sources})
+target_link_libraries({name} PUBLIC ufcx::ufcx)
+if(NOT WIN32)
+  target_link_libraries({name} PRIVATE m)
+endif()
+set_target_properties({name} PROPERTIES POSITION_INDEPENDENT_CODE ON
+                      PUBLIC_HEADER "{headers}")
+target_include_directories({name} PUBLIC $<BUILD_INTERFACE:${{CMAKE_CURRENT_SOURCE_DIR}}>
+                           $<INSTALL_INTERFACE:${{CMAKE_INSTALL_INCLUDEDIR}}>)
+
+install(TARGETS {name}
+        ARCHIVE DESTINATION ${{CMAKE_INSTALL_LIBDIR}}
+        LIBRARY DESTINATION ${{CMAKE_INSTALL_LIBDIR}}
+        RUNTIME DESTINATION ${{CMAKE_INSTALL_BINDIR}}
+        PUBLIC_HEADER DESTINATION ${{CMAKE_INSTALL_INCLUDEDIR}})
+"""
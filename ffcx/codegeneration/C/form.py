@@ -17,7 +17,11 @@ import typing
 
 import numpy as np
 
+import ffcx.codegeneration.lnodes as L
 from ffcx.codegeneration.C import form_template
+from ffcx.codegeneration.C.c_implementation import CFormatter
+from ffcx.codegeneration.geometry import affine_geometry_offsets, jacobian_determinant_inverse
+from ffcx.codegeneration.utils import dtype_to_c_type, dtype_to_scalar_dtype
 from ffcx.ir.representation import FormIR
 
 logger = logging.getLogger("ffcx")
@@ -34,6 +38,8 @@ def generator(ir: FormIR, options):
     d["name_from_uflfile"] = ir.name_from_uflfile
     d["signature"] = f'"{ir.signature}"'
     d["rank"] = ir.rank
+    d["has_action_kernels"] = "true" if ir.has_action_kernels else "false"
+    d.update(_geometry_kernel(ir, options))
     d["num_coefficients"] = ir.num_coefficients
 
     if len(ir.original_coefficient_positions) > 0:
@@ -185,3 +191,45 @@ def generator(ir: FormIR, options):
     )
 
     return declaration, implementation
+
+
+def _geometry_kernel(ir: FormIR, options) -> dict[str, typing.Union[int, str]]:
+    """Format the kernel computing the geometry read by the tabulate_tensor_geometry kernels.
+
+    The geometry is the Jacobian J[i][j] = x_{j+1}[i] - x_0[i] of the
+    affine map from the reference simplex with vertices x_k, followed by
+    detJ and K, see `affine_geometry_offsets`.
+    """
+    d: dict[str, typing.Union[int, str]] = {
+        "tabulate_geometry_float32": ".tabulate_geometry_float32 = NULL,",
+        "tabulate_geometry_float64": ".tabulate_geometry_float64 = NULL,",
+        "geometry_kernel": "",
+        "geometry_size": 0,
+    }
+    if not ir.geometry_shape:
+        return d
+
+    gdim, tdim = ir.geometry_shape
+    detJ_offset, K_offset, size = affine_geometry_offsets(gdim, tdim)
+    geometry = L.Symbol("geometry", dtype=L.DataType.REAL)
+    J = [[geometry[i * tdim + j] for j in range(tdim)] for i in range(gdim)]
+    detJ, K = jacobian_determinant_inverse(J)
+    statements = [L.Assign(geometry[detJ_offset], detJ)]
+    statements += [
+        L.Assign(geometry[K_offset + i * gdim + j], K[i][j])
+        for i in range(tdim)
+        for j in range(gdim)
+    ]
+
+    geom_dtype = dtype_to_scalar_dtype(options["scalar_type"])
+    d["geometry_size"] = size
+    d["geometry_kernel"] = form_template.geometry_kernel.format(
+        factory_name=ir.name,
+        geom_type=dtype_to_c_type(geom_dtype),
+        gdim=gdim,
+        tdim=tdim,
+        inverse=CFormatter(geom_dtype).c_format(L.StatementList(statements)),
+    )
+    name = np.dtype(geom_dtype).name
+    d[f"tabulate_geometry_{name}"] = f".tabulate_geometry_{name} = tabulate_geometry_{ir.name},"
+    return d
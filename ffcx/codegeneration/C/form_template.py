@@ -28,6 +28,7 @@ factory = """
 {constant_names_init}
 {constant_ranks_init}
 {constant_shapes_init}
+{geometry_kernel}
 
 ufcx_form {factory_name} =
 {{
@@ -48,7 +49,11 @@ ufcx_form {factory_name} =
 
   .form_integrals = {form_integrals},
   .form_integral_ids = {form_integral_ids},
-  .form_integral_offsets = form_integral_offsets_{factory_name}
+  .form_integral_offsets = form_integral_offsets_{factory_name},
+  .has_action_kernels = {has_action_kernels},
+  .geometry_size = {geometry_size},
+  {tabulate_geometry_float32}
+  {tabulate_geometry_float64}
 }};
 
 // Alias name
@@ -56,3 +61,14 @@ ufcx_form* {name_from_uflfile} = &{factory_name};
 
 // End of code for form {factory_name}
 """
+
+geometry_kernel = """
+void tabulate_geometry_{factory_name}({geom_type}* restrict geometry,
+                                      const {geom_type}* restrict coordinate_dofs)
+{{
+  for (int i = 0; i < {gdim}; ++i)
+    for (int j = 0; j < {tdim}; ++j)
+      geometry[i * {tdim} + j] = coordinate_dofs[3 * (j + 1) + i] - coordinate_dofs[i];
+{inverse}
+}}
+"""
@@ -5,24 +5,67 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 """Generate UFC code for an integral."""
 
+import itertools
 import logging
+import re
 import sys
+import textwrap
+import typing
 
 import basix
+import basix.ufl
 import numpy as np
 
+import ffcx.codegeneration.lnodes as L
+from ffcx import profiling
 from ffcx.codegeneration.backend import FFCXBackend
 from ffcx.codegeneration.C import integrals_template as ufcx_integrals
-from ffcx.codegeneration.C.c_implementation import CFormatter
-from ffcx.codegeneration.integral_generator import IntegralGenerator
-from ffcx.codegeneration.utils import dtype_to_c_type, dtype_to_scalar_dtype
-from ffcx.ir.representation import IntegralIR
+from ffcx.codegeneration.C.c_implementation import (
+    CBlockFormatter,
+    CFormatter,
+    CVectorFormatter,
+    vector_type_name,
+)
+from ffcx.codegeneration.integral_generator import FusedIntegralGenerator, IntegralGenerator
+from ffcx.codegeneration.utils import (
+    dtype_to_c_type,
+    dtype_to_scalar_dtype,
+    dtype_with_precision,
+)
+from ffcx.ir.representation import FusedIntegralIR, IntegralIR
 
 logger = logging.getLogger("ffcx")
 
+# Instruction sets of the kernels generated with the isa_dispatch
+# option for each architecture, from the most to the least capable:
+# name, target attribute and the CPU features selecting the kernels,
+# checked by __builtin_cpu_supports on x86-64 and in the hardware
+# capabilities of getauxval(AT_HWCAP) on AArch64
+isa_targets = {
+    "x86_64": (
+        ("avx512", "avx512f,avx512dq,avx512vl,avx2,fma", ("avx512f", "avx512dq", "avx512vl")),
+        ("avx2", "avx2,fma", ("avx2", "fma")),
+        ("sse4", "sse4.2", ("sse4.2",)),
+    ),
+    # NEON (Advanced SIMD) is part of the AArch64 base architecture, so
+    # its kernels are selected on all CPUs without SVE
+    "aarch64": (
+        ("sve", "arch=armv8.2-a+sve", ("SVE",)),
+        ("neon", "arch=armv8-a+simd", ("ASIMD",)),
+    ),
+}
 
-def generator(ir: IntegralIR, domain: basix.CellType, options):
-    """Generate C code for an integral."""
+
+def generator(ir: IntegralIR, domain: basix.CellType, options, table_pool=None):
+    """Generate C code for an integral.
+
+    Args:
+        ir: Intermediate representation of the integral.
+        domain: Cell type of the integration domain.
+        options: Options.
+        table_pool: Pool of static tables shared by the kernels of the
+            module, or None to declare the tables in each kernel.
+    """
     logger.info("Generating code for integral:")
     logger.info(f"--- type: {ir.expression.integral_type}")
     logger.info(f"--- name: {ir.expression.name}")
@@ -34,16 +77,21 @@ def generator(ir: IntegralIR, domain: basix.CellType, options):
 
     # Create FFCx C backend
     backend = FFCXBackend(ir, options)
+    accumulation_begin, accumulation_end = _accumulation_code(ir, options)
+    if accumulation_begin:
+        backend.symbols.element_tensor = L.Symbol("A_acc", dtype=L.DataType.SCALAR)
 
     # Configure kernel generator
-    ig = IntegralGenerator(ir, backend)
+    ig = IntegralGenerator(ir, backend, table_pool)
 
-    # Generate code ast for the tabulate_tensor body
-    parts = ig.generate(domain)
+    with profiling.scope(ir.expression.name):
+        # Generate code ast for the tabulate_tensor body
+        parts = ig.generate(domain)
 
-    # Format code as string
-    CF = CFormatter(options["scalar_type"])
-    body = CF.c_format(parts)
+        # Format code as string
+        with profiling.timer("c_format"):
+            CF = _formatter(options)
+            body = accumulation_begin + CF.c_format(parts) + accumulation_end
 
     # Generate generic FFCx code snippets and add specific parts
     code = {}
@@ -61,26 +109,160 @@ def generator(ir: IntegralIR, domain: basix.CellType, options):
 
     code["tabulate_tensor"] = body
 
-    code["tabulate_tensor_float32"] = ".tabulate_tensor_float32 = NULL,"
-    code["tabulate_tensor_float64"] = ".tabulate_tensor_float64 = NULL,"
-    if sys.platform.startswith("win32"):
-        code["tabulate_tensor_complex64"] = ""
-        code["tabulate_tensor_complex128"] = ""
-    else:
-        code["tabulate_tensor_complex64"] = ".tabulate_tensor_complex64 = NULL,"
-        code["tabulate_tensor_complex128"] = ".tabulate_tensor_complex128 = NULL,"
     np_scalar_type = np.dtype(options["scalar_type"]).name
-    code[f"tabulate_tensor_{np_scalar_type}"] = (
-        f".tabulate_tensor_{np_scalar_type} = tabulate_tensor_{factory_name},"
+    kernels = (
+        "tabulate_tensor",
+        "tabulate_tensor_batch",
+        "tabulate_action",
+        "tabulate_tensor_geometry",
+        "tabulate_tensor_gather",
+        "tabulate_tensor_scatter",
+        "tabulate_tensor_permuted",
     )
+    for kernel in kernels:
+        code[f"{kernel}_float32"] = f".{kernel}_float32 = NULL,"
+        code[f"{kernel}_float64"] = f".{kernel}_float64 = NULL,"
+        if sys.platform.startswith("win32"):
+            code[f"{kernel}_complex64"] = ""
+            code[f"{kernel}_complex128"] = ""
+        else:
+            code[f"{kernel}_complex64"] = f".{kernel}_complex64 = NULL,"
+            code[f"{kernel}_complex128"] = f".{kernel}_complex128 = NULL,"
+        code[f"{kernel}_{np_scalar_type}"] = (
+            f".{kernel}_{np_scalar_type} = {kernel}_{factory_name},"
+        )
+
+
+    # Matrix-free action of a bilinear form integral
+    code["action_kernel"] = ""
+    if ir.action is not None:
+        code["action_kernel"] = _action_kernel(ir, domain, factory_name, options, table_pool)
+    else:
+        code[f"tabulate_action_{np_scalar_type}"] = f".tabulate_action_{np_scalar_type} = NULL,"
+
+    # Kernel reading J, detJ and K from precomputed geometry
+    code["geometry_kernel"] = ""
+    if ir.geometry_size > 0:
+        code["geometry_kernel"] = _geometry_kernel(ir, domain, factory_name, options, table_pool)
+    else:
+        code[f"tabulate_tensor_geometry_{np_scalar_type}"] = (
+            f".tabulate_tensor_geometry_{np_scalar_type} = NULL,"
+        )
+
+    # Kernel reading the coefficients from their global dof arrays
+    code["gather_kernel"] = ""
+    if options["gather_kernels"] and _supports_gather(ir):
+        code["gather_kernel"] = _gather_kernel(ir, domain, factory_name, options, table_pool)
+    else:
+        code[f"tabulate_tensor_gather_{np_scalar_type}"] = (
+            f".tabulate_tensor_gather_{np_scalar_type} = NULL,"
+        )
+
+    # Kernel adding the element tensor directly into global values
+    code["scatter_kernel"] = ""
+    if options["scatter_kernels"] and not accumulation_begin:
+        code["scatter_kernel"] = _scatter_kernel(ir, domain, factory_name, options, table_pool)
+    else:
+        code[f"tabulate_tensor_scatter_{np_scalar_type}"] = (
+            f".tabulate_tensor_scatter_{np_scalar_type} = NULL,"
+        )
+
+    # Kernels specialised for each pair of quadrature permutations
+    num_permutations = _num_quadrature_permutations(ir, domain, options)
+    code["permuted_kernels"] = ""
+    if num_permutations > 0:
+        code["permuted_kernels"] = _permuted_kernels(
+            ir, domain, factory_name, num_permutations, options, table_pool
+        )
+    else:
+        code[f"tabulate_tensor_permuted_{np_scalar_type}"] = (
+            f".tabulate_tensor_permuted_{np_scalar_type} = NULL,"
+        )
+
+    # Fused kernel also computing the integrals of other forms
+    code["fused_declaration"] = ""
+    code["fused"] = "NULL"
+    if ir.fused_integral is not None:
+        fused_name = f"{ir.fused_integral}_{domain.name}"
+        code["fused_declaration"] = ufcx_integrals.fused_declaration.format(
+            factory_name=fused_name
+        )
+        code["fused"] = f"&{fused_name}"
+
+    # Static cost estimates and runtime statistics
+    code["flops_per_call"] = L.count_flops(parts)
+    code["bytes_per_call"] = _bytes_per_call(ir, options)
+    if options["kernel_stats"]:
+        code["stats_init"] = f"static ufcx_integral_stats stats_{factory_name} = {{0}};"
+        code["stats_begin"], code["stats_end"] = _stats_code(factory_name, 1)
+        code["stats"] = f"&stats_{factory_name}"
+    else:
+        code["stats_init"] = ""
+        code["stats_begin"], code["stats_end"] = "", ""
+        code["stats"] = "NULL"
+
+    # Cell-batched kernel, vectorised across cells
+    cell_batch_size = options["cell_batch_size"]
+    code["cell_batch_kernel"] = ""
+    code["tabulate_tensor_cell_batch_float32"] = ".tabulate_tensor_cell_batch_float32 = NULL,"
+    code["tabulate_tensor_cell_batch_float64"] = ".tabulate_tensor_cell_batch_float64 = NULL,"
+    if (
+        cell_batch_size > 1
+        and ir.expression.integral_type == "cell"
+        and not _is_mixed_precision(options)
+    ):
+        with profiling.scope(ir.expression.name), profiling.timer("c_format"):
+            code["cell_batch_kernel"] = _cell_batch_kernel(parts, factory_name, options)
+    if code["cell_batch_kernel"]:
+        code[f"tabulate_tensor_cell_batch_{np_scalar_type}"] = (
+            f".tabulate_tensor_cell_batch_{np_scalar_type} = "
+            f"tabulate_tensor_cell_batch_{factory_name},"
+        )
+    else:
+        cell_batch_size = 1
+
+    # Kernel tabulating a batch of cells, in blocks of cells
+    with profiling.scope(ir.expression.name), profiling.timer("c_format"):
+        batch_kernel = _batch_kernel(ir, parts, factory_name, options, accumulation_begin)
+
+    code["kernels"] = ufcx_integrals.kernels.format(
+        factory_name=factory_name,
+        scalar_type=dtype_to_c_type(options["scalar_type"]),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+        tabulate_tensor=code["tabulate_tensor"],
+        batch_kernel=batch_kernel,
+        stats_begin=code["stats_begin"],
+        stats_end=code["stats_end"],
+    )
+
+    # Instruction set specific copies of all kernels of the integral,
+    # selected when the code is loaded
+    code["isa_dispatch"] = ""
+    if options["isa_dispatch"]:
+        fields = ["tabulate_tensor", "tabulate_tensor_batch"]
+        kernels = [code["kernels"]]
+        variants = {
+            "tabulate_tensor_cell_batch": "cell_batch_kernel",
+            "tabulate_action": "action_kernel",
+            "tabulate_tensor_geometry": "geometry_kernel",
+            "tabulate_tensor_gather": "gather_kernel",
+            "tabulate_tensor_scatter": "scatter_kernel",
+            "tabulate_tensor_permuted": "permuted_kernels",
+        }
+        for field, key in variants.items():
+            if code[key]:
+                fields.append(field)
+                kernels.append(code[key])
+        code["isa_dispatch"] = _isa_dispatch(factory_name, fields, "".join(kernels), options)
 
     assert ir.expression.coordinate_element_hash is not None
     implementation = ufcx_integrals.factory.format(
         factory_name=factory_name,
         enabled_coefficients=code["enabled_coefficients"],
         enabled_coefficients_init=code["enabled_coefficients_init"],
-        tabulate_tensor=code["tabulate_tensor"],
+        kernels=code["kernels"],
         needs_facet_permutations="true" if ir.expression.needs_facet_permutations else "false",
+        symmetric="true" if ir.expression.symmetric else "false",
         scalar_type=dtype_to_c_type(options["scalar_type"]),
         geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
         coordinate_element_hash=f"UINT64_C({ir.expression.coordinate_element_hash})",
@@ -88,7 +270,624 @@ def generator(ir: IntegralIR, domain: basix.CellType, options):
         tabulate_tensor_float64=code["tabulate_tensor_float64"],
         tabulate_tensor_complex64=code["tabulate_tensor_complex64"],
         tabulate_tensor_complex128=code["tabulate_tensor_complex128"],
+        tabulate_tensor_batch_float32=code["tabulate_tensor_batch_float32"],
+        tabulate_tensor_batch_float64=code["tabulate_tensor_batch_float64"],
+        tabulate_tensor_batch_complex64=code["tabulate_tensor_batch_complex64"],
+        tabulate_tensor_batch_complex128=code["tabulate_tensor_batch_complex128"],
+        cell_batch_kernel=code["cell_batch_kernel"],
+        action_kernel=code["action_kernel"],
+        tabulate_action_float32=code["tabulate_action_float32"],
+        tabulate_action_float64=code["tabulate_action_float64"],
+        tabulate_action_complex64=code["tabulate_action_complex64"],
+        tabulate_action_complex128=code["tabulate_action_complex128"],
+        geometry_kernel=code["geometry_kernel"],
+        gather_kernel=code["gather_kernel"],
+        tabulate_tensor_gather_float32=code["tabulate_tensor_gather_float32"],
+        tabulate_tensor_gather_float64=code["tabulate_tensor_gather_float64"],
+        tabulate_tensor_gather_complex64=code["tabulate_tensor_gather_complex64"],
+        tabulate_tensor_gather_complex128=code["tabulate_tensor_gather_complex128"],
+        scatter_kernel=code["scatter_kernel"],
+        tabulate_tensor_scatter_float32=code["tabulate_tensor_scatter_float32"],
+        tabulate_tensor_scatter_float64=code["tabulate_tensor_scatter_float64"],
+        tabulate_tensor_scatter_complex64=code["tabulate_tensor_scatter_complex64"],
+        tabulate_tensor_scatter_complex128=code["tabulate_tensor_scatter_complex128"],
+        permuted_kernels=code["permuted_kernels"],
+        num_quadrature_permutations=num_permutations,
+        tabulate_tensor_permuted_float32=code["tabulate_tensor_permuted_float32"],
+        tabulate_tensor_permuted_float64=code["tabulate_tensor_permuted_float64"],
+        tabulate_tensor_permuted_complex64=code["tabulate_tensor_permuted_complex64"],
+        tabulate_tensor_permuted_complex128=code["tabulate_tensor_permuted_complex128"],
+        fused_declaration=code["fused_declaration"],
+        fused=code["fused"],
+        tabulate_tensor_geometry_float32=code["tabulate_tensor_geometry_float32"],
+        tabulate_tensor_geometry_float64=code["tabulate_tensor_geometry_float64"],
+        tabulate_tensor_geometry_complex64=code["tabulate_tensor_geometry_complex64"],
+        tabulate_tensor_geometry_complex128=code["tabulate_tensor_geometry_complex128"],
+        tabulate_tensor_cell_batch_float32=code["tabulate_tensor_cell_batch_float32"],
+        tabulate_tensor_cell_batch_float64=code["tabulate_tensor_cell_batch_float64"],
+        cell_batch_size=cell_batch_size,
+        flops_per_call=code["flops_per_call"],
+        bytes_per_call=code["bytes_per_call"],
+        stats_init=code["stats_init"],
+        stats_begin=code["stats_begin"],
+        stats_end=code["stats_end"],
+        stats=code["stats"],
+        isa_dispatch=code["isa_dispatch"],
         domain=int(domain),
     )
 
+    with profiling.scope(ir.expression.name):
+        profiling.record("code_size", len(implementation))
+
     return declaration, implementation
+
+
+def fused_generator(ir: FusedIntegralIR, domain: basix.CellType, options, table_pool):
+    """Generate C code for a fused integral.
+
+    Args:
+        ir: Intermediate representation of the fused integral.
+        domain: Cell type of the integration domain.
+        options: Options.
+        table_pool: Pool of static tables shared by the kernels of the
+            module.
+    """
+    logger.info("Generating code for fused integral:")
+    logger.info(f"--- name: {ir.name}")
+    logger.info(f"--- integrals: {', '.join(i.expression.name for i in ir.integrals)}")
+
+    factory_name = f"{ir.name}_{domain.name}"
+    declaration = ufcx_integrals.fused_declaration.format(factory_name=factory_name)
+
+    backend = FFCXBackend(ir.integrals[0], options)
+    accumulate = _accumulation_code(ir.integrals[0], options)[0] != ""
+    element_tensor = "A_{k}_acc" if accumulate else "A_{k}"
+    ig = FusedIntegralGenerator(ir.integrals, backend, table_pool, element_tensor)
+
+    with profiling.scope(ir.name):
+        parts = ig.generate(domain)
+        with profiling.timer("c_format"):
+            CF = _formatter(options)
+            body = CF.c_format(parts)
+
+    # Accumulate the tensors of the integrals over the domain in the
+    # accumulation precision
+    if accumulate:
+        accumulation = [
+            _accumulation_code(integral_ir, options, f"A_{k}")
+            for k, integral_ir in enumerate(ir.integrals)
+            if re.search(rf"\bA_{k}_acc\b", body)
+        ]
+        body = "".join(a[0] for a in accumulation) + body + "".join(a[1] for a in accumulation)
+
+    # Unpack the per-integral arguments used by the kernel
+    scalar_type = dtype_to_c_type(options["scalar_type"])
+    arguments = []
+    for k in range(len(ir.integrals)):
+        for name, qualifier in (("A", ""), ("w", "const "), ("c", "const ")):
+            if re.search(rf"\b{name}_{k}\b", body):
+                arguments += [f"{qualifier}{scalar_type}* restrict {name}_{k} = {name}[{k}];"]
+
+    np_scalar_type = np.dtype(options["scalar_type"]).name
+    code = {}
+    code["tabulate_tensor_float32"] = ".tabulate_tensor_float32 = NULL,"
+    code["tabulate_tensor_float64"] = ".tabulate_tensor_float64 = NULL,"
+    if sys.platform.startswith("win32"):
+        code["tabulate_tensor_complex64"] = ""
+        code["tabulate_tensor_complex128"] = ""
+    else:
+        code["tabulate_tensor_complex64"] = ".tabulate_tensor_complex64 = NULL,"
+        code["tabulate_tensor_complex128"] = ".tabulate_tensor_complex128 = NULL,"
+    code[f"tabulate_tensor_{np_scalar_type}"] = (
+        f".tabulate_tensor_{np_scalar_type} = tabulate_tensor_{factory_name},"
+    )
+
+    kernel = ufcx_integrals.fused_kernel.format(
+        factory_name=factory_name,
+        scalar_type=scalar_type,
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+        arguments="\n".join(arguments),
+        tabulate_tensor=body,
+    )
+    isa_dispatch = ""
+    if options["isa_dispatch"]:
+        isa_dispatch = _isa_dispatch(factory_name, ["tabulate_tensor"], kernel, options)
+
+    implementation = ufcx_integrals.fused_factory.format(
+        factory_name=factory_name,
+        kernel=kernel,
+        isa_dispatch=isa_dispatch,
+        num_integrals=len(ir.integrals),
+        integrals=", ".join(f"&{i.expression.name}_{domain.name}" for i in ir.integrals),
+        flops_per_call=L.count_flops(parts),
+        **code,
+    )
+
+    with profiling.scope(ir.name):
+        profiling.record("code_size", len(implementation))
+
+    return declaration, implementation
+
+
+def entity_sizes(ir: IntegralIR) -> dict[str, int]:
+    """Sizes of the per-entity arguments of the single entity kernel.
+
+    Used as the strides of these arguments by the kernels tabulating a
+    batch of entities. The constants c are shared by all entities.
+    """
+    integral_type = ir.expression.integral_type
+    num_entities = {"cell": 0, "exterior_facet": 1, "interior_facet": 2, "vertex": 1}
+    num_permutations = 0
+    if ir.expression.needs_facet_permutations:
+        num_permutations = 2 if integral_type == "interior_facet" else 1
+    return {
+        "A": int(np.prod(ir.expression.tensor_shape, dtype=int)),
+        "w": ir.coefficient_size,
+        "coordinate_dofs": ir.coordinate_dofs_size,
+        "entity_local_index": num_entities.get(integral_type, 0),
+        "quadrature_permutation": num_permutations,
+    }
+
+
+def _batch_arguments(ir: IntegralIR) -> str:
+    """Arguments passed from the batched kernel to the single entity kernel.
+
+    Each per-entity argument is offset by its size in the single entity
+    kernel, with the index cell of type ptrdiff_t so the offsets of large
+    batches do not overflow. Arguments with no per-entity data are
+    passed unchanged, so null pointers stay null.
+    """
+
+    def offset(name: str, size: int) -> str:
+        return f"{name} + cell * {size}" if size > 0 else name
+
+    sizes = entity_sizes(ir)
+    return ", ".join(
+        [
+            offset("A", sizes["A"]),
+            offset("w", sizes["w"]),
+            "c",
+            offset("coordinate_dofs", sizes["coordinate_dofs"]),
+            offset("entity_local_index", sizes["entity_local_index"]),
+            offset("quadrature_permutation", sizes["quadrature_permutation"]),
+        ]
+    )
+
+
+def _batch_kernel(
+    ir: IntegralIR, parts, factory_name: str, options, accumulation_begin: str
+) -> str:
+    """Format the kernel tabulating a batch of cells (entities).
+
+    The cells are tabulated in blocks of batch_block_size cells, with the
+    loop over the cells of a block innermost (see CBlockFormatter). The
+    kernel falls back to calling the single entity kernel for each cell
+    if the block size is 1, the element tensor is accumulated in another
+    precision, or the kernel body cannot be formatted for blocks.
+    """
+    scalar_type = options["scalar_type"]
+    block_size = options["batch_block_size"]
+    body = ""
+    if block_size > 1 and not accumulation_begin:
+        try:
+            BF = CBlockFormatter(
+                dtype_with_precision(scalar_type, options["compute_precision"]),
+                dtype_with_precision(scalar_type, options["geometry_precision"]),
+                options["table_alignment"],
+                options["simd_hints"],
+                dtype_with_precision(scalar_type, options["compute_precision"]),
+                block_size,
+                entity_sizes(ir),
+            )
+            body = BF.c_format(parts)
+        except NotImplementedError as e:
+            logger.info(f"Blocked batch kernel not generated for {factory_name}: {e}")
+
+    if not body:
+        return ufcx_integrals.batch_kernel.format(
+            factory_name=factory_name,
+            scalar_type=dtype_to_c_type(scalar_type),
+            geom_type=dtype_to_c_type(dtype_to_scalar_dtype(scalar_type)),
+            batch_arguments=_batch_arguments(ir),
+        )
+
+    stats_begin, stats_end = "", ""
+    if options["kernel_stats"]:
+        stats_begin, stats_end = _stats_code(factory_name, "num_cells")
+
+    return ufcx_integrals.block_batch_kernel.format(
+        factory_name=factory_name,
+        scalar_type=dtype_to_c_type(scalar_type),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(scalar_type)),
+        block_size=block_size,
+        stats_begin=stats_begin,
+        stats_end=stats_end,
+        tabulate_tensor=textwrap.indent(body, "  "),
+    )
+
+
+def _action_kernel(
+    ir: IntegralIR, domain: basix.CellType, factory_name: str, options, table_pool
+) -> str:
+    """Format the matrix-free action kernel y += A x of a bilinear form integral.
+
+    The kernel is generated from the action integrand, in which the trial
+    function is replaced by a coefficient with dofs x, so the element
+    tensor A is never formed.
+    """
+    action_ir = ir._replace(expression=ir.action, rank=1, action=None)
+    backend = FFCXBackend(action_ir, options)
+    backend.symbols.action_coefficient = ir.action_coefficient
+    backend.symbols.element_tensor = L.Symbol("y", dtype=L.DataType.SCALAR)
+    accumulation_begin, accumulation_end = _accumulation_code(action_ir, options, "y")
+    if accumulation_begin:
+        backend.symbols.element_tensor = L.Symbol("y_acc", dtype=L.DataType.SCALAR)
+    ig = IntegralGenerator(action_ir, backend, table_pool)
+
+    with profiling.scope(f"{ir.expression.name}_action"):
+        parts = ig.generate(domain)
+        with profiling.timer("c_format"):
+            CF = _formatter(options)
+            body = accumulation_begin + CF.c_format(parts) + accumulation_end
+
+    return ufcx_integrals.action_kernel.format(
+        factory_name=factory_name,
+        scalar_type=dtype_to_c_type(options["scalar_type"]),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+        tabulate_action=body,
+    )
+
+
+def _geometry_kernel(
+    ir: IntegralIR, domain: basix.CellType, factory_name: str, options, table_pool
+) -> str:
+    """Format the tabulate_tensor kernel reading J, detJ and K from precomputed geometry.
+
+    The geometry of the cells is computed once by the tabulate_geometry
+    kernel of the form, and shared by all integrals over the same mesh.
+    """
+    backend = FFCXBackend(ir, options)
+    backend.symbols.precomputed_geometry = L.Symbol("geometry", dtype=L.DataType.REAL)
+    accumulation_begin, accumulation_end = _accumulation_code(ir, options)
+    if accumulation_begin:
+        backend.symbols.element_tensor = L.Symbol("A_acc", dtype=L.DataType.SCALAR)
+    ig = IntegralGenerator(ir, backend, table_pool)
+
+    with profiling.scope(f"{ir.expression.name}_geometry"):
+        parts = ig.generate(domain)
+        with profiling.timer("c_format"):
+            CF = _formatter(options)
+            body = accumulation_begin + CF.c_format(parts) + accumulation_end
+
+    return ufcx_integrals.geometry_kernel.format(
+        factory_name=factory_name,
+        scalar_type=dtype_to_c_type(options["scalar_type"]),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+        tabulate_tensor=body,
+    )
+
+
+def _supports_gather(ir: IntegralIR) -> bool:
+    """Check if the coefficients of an integral can be read from their global dof arrays.
+
+    The dofs of a coefficient are gathered through the dofmap of its
+    element, which must not be mixed, have global dofs or need dof
+    transformations, as these are applied when packing.
+    """
+    for coefficient in ir.expression.coefficient_offsets:
+        element = coefficient.ufl_function_space().ufl_element()
+        if (
+            isinstance(element, basix.ufl._MixedElement)
+            or element.num_global_support_dofs > 0
+            or not element.dof_transformations_are_identity
+        ):
+            return False
+    return True
+
+
+def _gather_kernel(
+    ir: IntegralIR, domain: basix.CellType, factory_name: str, options, table_pool
+) -> str:
+    """Format the tabulate_tensor kernel reading the coefficients from their global dof arrays.
+
+    The coefficient dofs are read through the dofmaps of the cells of the
+    entity, so the assembler does not pack them.
+    """
+    backend = FFCXBackend(ir, options)
+    backend.symbols.coefficient_dofmaps = L.Symbol("dofmaps", dtype=L.DataType.INT)
+    accumulation_begin, accumulation_end = _accumulation_code(ir, options)
+    if accumulation_begin:
+        backend.symbols.element_tensor = L.Symbol("A_acc", dtype=L.DataType.SCALAR)
+    ig = IntegralGenerator(ir, backend, table_pool)
+
+    with profiling.scope(f"{ir.expression.name}_gather"):
+        parts = ig.generate(domain)
+        with profiling.timer("c_format"):
+            CF = _formatter(options)
+            body = accumulation_begin + CF.c_format(parts) + accumulation_end
+
+    return ufcx_integrals.gather_kernel.format(
+        factory_name=factory_name,
+        scalar_type=dtype_to_c_type(options["scalar_type"]),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+        tabulate_tensor=body,
+    )
+
+
+def _scatter_kernel(
+    ir: IntegralIR, domain: basix.CellType, factory_name: str, options, table_pool
+) -> str:
+    """Format the tabulate_tensor kernel adding the element tensor into global values.
+
+    The contributions of the loops of the kernel are added to the
+    entries of the global values at the positions of the entries of the
+    element tensor, so no element tensor is stored.
+    """
+    backend = FFCXBackend(ir, options)
+    backend.symbols.element_tensor = L.Symbol("values", dtype=L.DataType.SCALAR)
+    backend.symbols.element_tensor_positions = L.Symbol("positions", dtype=L.DataType.INT)
+    ig = IntegralGenerator(ir, backend, table_pool)
+
+    with profiling.scope(f"{ir.expression.name}_scatter"):
+        parts = ig.generate(domain)
+        with profiling.timer("c_format"):
+            CF = _formatter(options)
+            CF.atomic_arrays.add("values")
+            body = CF.c_format(parts)
+
+    return ufcx_integrals.scatter_kernel.format(
+        factory_name=factory_name,
+        scalar_type=dtype_to_c_type(options["scalar_type"]),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"])),
+        tabulate_tensor=body,
+    )
+
+
+def _num_quadrature_permutations(ir: IntegralIR, domain: basix.CellType, options) -> int:
+    """Number of quadrature permutations of the permuted tables of an interior facet integral.
+
+    Returns 0 if no specialised kernels are generated, i.e. if the option
+    is not set, the integral is not over interior facets or none of its
+    tables depend on the quadrature permutation.
+    """
+    if (
+        not options["permuted_kernels"]
+        or ir.expression.integral_type != "interior_facet"
+        or not ir.expression.needs_facet_permutations
+    ):
+        return 0
+    tables = ir.expression.unique_tables.get(domain, {}).values()
+    num_permutations = max((table.shape[0] for table in tables), default=1)
+    return num_permutations if num_permutations > 1 else 0
+
+
+def _permuted_kernels(
+    ir: IntegralIR,
+    domain: basix.CellType,
+    factory_name: str,
+    num_permutations: int,
+    options,
+    table_pool,
+) -> str:
+    """Format the tabulate_tensor kernels specialised for each pair of quadrature permutations.
+
+    The quadrature permutations of the two facets are literals in each
+    kernel, so the permuted tables are accessed at fixed offsets and the
+    kernels are free of runtime table selection.
+    """
+    scalar_type = dtype_to_c_type(options["scalar_type"])
+    geom_type = dtype_to_c_type(dtype_to_scalar_dtype(options["scalar_type"]))
+    accumulation_begin, accumulation_end = _accumulation_code(ir, options)
+
+    kernels = []
+    names = []
+    for perm0, perm1 in itertools.product(range(num_permutations), repeat=2):
+        backend = FFCXBackend(ir, options)
+        backend.symbols.quadrature_permutation = (L.LiteralInt(perm0), L.LiteralInt(perm1))
+        if accumulation_begin:
+            backend.symbols.element_tensor = L.Symbol("A_acc", dtype=L.DataType.SCALAR)
+        ig = IntegralGenerator(ir, backend, table_pool)
+
+        with profiling.scope(f"{ir.expression.name}_{perm0}_{perm1}"):
+            parts = ig.generate(domain)
+            with profiling.timer("c_format"):
+                CF = _formatter(options)
+                body = accumulation_begin + CF.c_format(parts) + accumulation_end
+
+        kernels += [
+            ufcx_integrals.permuted_kernel.format(
+                factory_name=factory_name,
+                perm0=perm0,
+                perm1=perm1,
+                scalar_type=scalar_type,
+                geom_type=geom_type,
+                tabulate_tensor=body,
+            )
+        ]
+        names += [f"tabulate_tensor_{factory_name}_{perm0}_{perm1}"]
+
+    kernels += [
+        ufcx_integrals.permuted_kernels.format(
+            factory_name=factory_name,
+            np_scalar_type=np.dtype(options["scalar_type"]).name,
+            size=len(names),
+            kernels=",\n  ".join(names),
+        )
+    ]
+    return "".join(kernels)
+
+
+def _isa_dispatch(factory_name: str, fields: list[str], kernels: str, options) -> str:
+    """Copies of the kernels for each instruction set, and their selection.
+
+    Args:
+        factory_name: Name of the ufcx_integral or ufcx_fused_integral.
+        fields: Kernel pointers of the struct set to the copies. The
+            kernel of field f is f_{factory_name}.
+        kernels: Code of the kernels. The functions it defines, and the
+            kernels of the fields, are renamed with the instruction set
+            as suffix in the copies.
+        options: Options.
+    """
+    names = set(re.findall(r"^void (\w+)\(", kernels, flags=re.MULTILINE))
+    names.update(f"{field}_{factory_name}" for field in fields)
+    pattern = re.compile(r"\b(" + "|".join(sorted(names)) + r")\b")
+
+    np_scalar_type = np.dtype(options["scalar_type"]).name
+    dispatch = []
+    for arch, targets in isa_targets.items():
+        copies = []
+        selection = []
+        for i, (isa, target, features) in enumerate(targets):
+            copy = pattern.sub(rf"\1_{isa}", kernels)
+            copy = re.sub(
+                r"^void ",
+                f'__attribute__((target("{target}")))\nstatic void ',
+                copy,
+                flags=re.MULTILINE,
+            )
+            copies.append(copy)
+            assignments = [
+                ufcx_integrals.isa_assignment.format(
+                    factory_name=factory_name,
+                    field=field,
+                    np_scalar_type=np_scalar_type,
+                    kernel=f"{field}_{factory_name}",
+                    isa=isa,
+                )
+                for field in fields
+            ]
+            selection.append(
+                ufcx_integrals.isa_selection.format(
+                    condition="if " if i == 0 else "else if ",
+                    features=" && ".join(
+                        ufcx_integrals.isa_feature[arch].format(feature=f) for f in features
+                    ),
+                    assignments="\n".join(assignments),
+                )
+            )
+        dispatch.append(
+            ufcx_integrals.isa_dispatch.format(
+                arch=arch.upper(),
+                factory_name=factory_name,
+                kernels="".join(copies),
+                init=ufcx_integrals.isa_init[arch],
+                selection="".join(selection),
+            )
+        )
+    return "".join(dispatch)
+
+
+def _formatter(options) -> CFormatter:
+    """Formatter of integral kernel bodies, with the precisions of the computed values."""
+    scalar_type = options["scalar_type"]
+    return CFormatter(
+        dtype_with_precision(scalar_type, options["compute_precision"]),
+        dtype_with_precision(scalar_type, options["geometry_precision"]),
+        options["table_alignment"],
+        options["simd_hints"],
+        table_dtype=dtype_with_precision(scalar_type, options["compute_precision"]),
+    )
+
+
+def _is_mixed_precision(options) -> bool:
+    """Check if values are computed in a precision other than that of the scalar type."""
+    scalar_type = np.dtype(options["scalar_type"])
+    return any(
+        dtype_with_precision(scalar_type, options[f"{kind}_precision"]) != scalar_type
+        for kind in ("compute", "geometry", "accumulation")
+    )
+
+
+def _accumulation_code(ir: IntegralIR, options, target: str = "A") -> tuple[str, str]:
+    """Code accumulating the element tensor in the accumulation precision.
+
+    The kernel body accumulates into a local tensor {target}_acc, which
+    is added to the output tensor target at the end. Both strings are
+    empty if the element tensor is accumulated in target directly.
+    """
+    scalar_type = np.dtype(options["scalar_type"])
+    accumulation_type = dtype_with_precision(scalar_type, options["accumulation_precision"])
+    if accumulation_type == scalar_type:
+        return "", ""
+    size = int(np.prod(ir.expression.tensor_shape, dtype=int))
+    local = f"{target}_acc"
+    begin = f"{dtype_to_c_type(accumulation_type)} {local}[{size}] = {{0}};\n"
+    end = f"for (int i = 0; i < {size}; ++i)\n  {target}[i] += {local}[i];\n"
+    return begin, end
+
+
+def _bytes_per_call(ir: IntegralIR, options) -> int:
+    """Estimated number of bytes of the kernel arguments accessed for one entity.
+
+    The element tensor is read and written, the coefficients and
+    coordinate dofs are read. The constants are left out, as they are
+    the same for all entities and not streamed from memory per call.
+    """
+    scalar_size = np.dtype(options["scalar_type"]).itemsize
+    geom_size = np.dtype(dtype_to_scalar_dtype(options["scalar_type"])).itemsize
+    tensor_size = int(np.prod(ir.expression.tensor_shape, dtype=int))
+    return (
+        scalar_size * (2 * tensor_size + ir.coefficient_size)
+        + geom_size * ir.coordinate_dofs_size
+    )
+
+
+def _stats_code(factory_name: str, num_entities: typing.Union[int, str]) -> tuple[str, str]:
+    """Code updating the runtime statistics at the start and end of a kernel.
+
+    Args:
+        factory_name: Name of the ufcx_integral.
+        num_entities: Number of entities tabulated by a call, a number
+            or the name of the kernel argument holding it.
+    """
+    stats = f"stats_{factory_name}"
+    begin = f"const uint64_t stats_t0 = {stats}.clock ? {stats}.clock() : 0;"
+    end = (
+        f"if ({stats}.clock)\n"
+        f"  {stats}.ticks += {stats}.clock() - stats_t0;\n"
+        f"{stats}.num_calls += {num_entities};"
+    )
+    return begin, end
+
+
+def _cell_batch_kernel(parts, factory_name: str, options) -> str:
+    """Format the cell-batched (vectorised across cells) kernel.
+
+    Returns an empty string if the kernel body uses operations without a
+    vector counterpart, in which case only the scalar kernels are
+    available.
+    """
+    scalar_type = options["scalar_type"]
+    if np.issubdtype(scalar_type, np.complexfloating):
+        return ""
+    arguments = {"A": False, "w": True, "coordinate_dofs": True}
+    try:
+        VF = CVectorFormatter(scalar_type, options["cell_batch_size"], list(arguments))
+        body = VF.c_format(parts)
+    except NotImplementedError as e:
+        logger.info(f"Cell-batched kernel not generated for {factory_name}: {e}")
+        return ""
+
+    vtype = vector_type_name(scalar_type)
+    vector_arguments = []
+    for name, const in arguments.items():
+        if name in VF.used_arguments:
+            qualifier = "const " if const else ""
+            vector_arguments += [
+                f"{qualifier}{vtype}* restrict {name} = ({qualifier}{vtype}*){name}_;"
+            ]
+
+    stats_begin, stats_end = "", ""
+    if options["kernel_stats"]:
+        stats_begin, stats_end = _stats_code(factory_name, options["cell_batch_size"])
+
+    return ufcx_integrals.cell_batch_kernel.format(
+        factory_name=factory_name,
+        stats_begin=stats_begin,
+        stats_end=stats_end,
+        scalar_type=dtype_to_c_type(scalar_type),
+        geom_type=dtype_to_c_type(dtype_to_scalar_dtype(scalar_type)),
+        vector_arguments="\n".join(vector_arguments),
+        tabulate_tensor=body,
+    )
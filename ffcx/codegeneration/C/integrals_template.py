@@ -10,7 +10,66 @@ extern ufcx_integral {factory_name};
 
 factory = """
 // Code for integral {factory_name}
+{stats_init}
+{kernels}
+{cell_batch_kernel}
+{action_kernel}
+{geometry_kernel}
+{gather_kernel}
+{scatter_kernel}
+{permuted_kernels}
+{fused_declaration}
+{enabled_coefficients_init}
 
+ufcx_integral {factory_name} =
+{{
+  .enabled_coefficients = {enabled_coefficients},
+  {tabulate_tensor_float32}
+  {tabulate_tensor_float64}
+  {tabulate_tensor_complex64}
+  {tabulate_tensor_complex128}
+  {tabulate_tensor_batch_float32}
+  {tabulate_tensor_batch_float64}
+  {tabulate_tensor_batch_complex64}
+  {tabulate_tensor_batch_complex128}
+  {tabulate_tensor_cell_batch_float32}
+  {tabulate_tensor_cell_batch_float64}
+  .cell_batch_size = {cell_batch_size},
+  {tabulate_action_float32}
+  {tabulate_action_float64}
+  {tabulate_action_complex64}
+  {tabulate_action_complex128}
+  {tabulate_tensor_geometry_float32}
+  {tabulate_tensor_geometry_float64}
+  {tabulate_tensor_geometry_complex64}
+  {tabulate_tensor_geometry_complex128}
+  {tabulate_tensor_gather_float32}
+  {tabulate_tensor_gather_float64}
+  {tabulate_tensor_gather_complex64}
+  {tabulate_tensor_gather_complex128}
+  {tabulate_tensor_scatter_float32}
+  {tabulate_tensor_scatter_float64}
+  {tabulate_tensor_scatter_complex64}
+  {tabulate_tensor_scatter_complex128}
+  .num_quadrature_permutations = {num_quadrature_permutations},
+  {tabulate_tensor_permuted_float32}
+  {tabulate_tensor_permuted_float64}
+  {tabulate_tensor_permuted_complex64}
+  {tabulate_tensor_permuted_complex128}
+  .flops_per_call = {flops_per_call},
+  .bytes_per_call = {bytes_per_call},
+  .stats = {stats},
+  .fused = {fused},
+  .needs_facet_permutations = {needs_facet_permutations},
+  .symmetric = {symmetric},
+  .coordinate_element_hash = {coordinate_element_hash},
+  .domain = {domain},
+}};
+{isa_dispatch}
+// End of code for integral {factory_name}
+"""
+
+kernels = """
 void tabulate_tensor_{factory_name}({scalar_type}* restrict A,
                                     const {scalar_type}* restrict w,
                                     const {scalar_type}* restrict c,
@@ -19,22 +78,209 @@ void tabulate_tensor_{factory_name}({scalar_type}* restrict A,
                                     const uint8_t* restrict quadrature_permutation,
                                     void* custom_data)
 {{
+{stats_begin}
 {tabulate_tensor}
+{stats_end}
 }}
+{batch_kernel}
+"""
 
-{enabled_coefficients_init}
+batch_kernel = """
+void tabulate_tensor_batch_{factory_name}({scalar_type}* restrict A,
+                                          const {scalar_type}* restrict w,
+                                          const {scalar_type}* restrict c,
+                                          const {geom_type}* restrict coordinate_dofs,
+                                          const int* restrict entity_local_index,
+                                          const uint8_t* restrict quadrature_permutation,
+                                          int num_cells,
+                                          void* custom_data)
+{{
+  for (ptrdiff_t cell = 0; cell < num_cells; ++cell)
+  {{
+    tabulate_tensor_{factory_name}({batch_arguments}, custom_data);
+  }}
+}}
+"""
 
-ufcx_integral {factory_name} =
+block_batch_kernel = """
+void tabulate_tensor_batch_{factory_name}({scalar_type}* restrict A,
+                                          const {scalar_type}* restrict w,
+                                          const {scalar_type}* restrict c,
+                                          const {geom_type}* restrict coordinate_dofs,
+                                          const int* restrict entity_local_index,
+                                          const uint8_t* restrict quadrature_permutation,
+                                          int num_cells,
+                                          void* custom_data)
 {{
-  .enabled_coefficients = {enabled_coefficients},
+{stats_begin}
+for (ptrdiff_t block = 0; block < num_cells; block += {block_size})
+{{
+  const int block_cells =
+      num_cells - block < {block_size} ? (int)(num_cells - block) : {block_size};
+{tabulate_tensor}
+}}
+{stats_end}
+}}
+"""
+
+isa_dispatch = """
+#ifdef FFCX_ISA_DISPATCH_{arch}
+{kernels}
+// Select the kernels for the instruction sets of the CPU when loaded
+__attribute__((constructor))
+static void dispatch_{factory_name}(void)
+{{
+{init}
+{selection}
+}}
+#endif
+"""
+
+# Setup of the CPU feature checks in the selection for each architecture
+isa_init = {
+    "x86_64": "  __builtin_cpu_init();",
+    "aarch64": "  const unsigned long hwcap = getauxval(AT_HWCAP);",
+}
+
+isa_feature = {
+    "x86_64": '__builtin_cpu_supports("{feature}")',
+    "aarch64": "(hwcap & HWCAP_{feature})",
+}
+
+isa_selection = """  {condition}({features})
+  {{
+{assignments}
+  }}
+"""
+
+isa_assignment = """    {factory_name}.{field}_{np_scalar_type} = {kernel}_{isa};"""
+
+cell_batch_kernel = """
+void tabulate_tensor_cell_batch_{factory_name}({scalar_type}* restrict A_,
+                                               const {scalar_type}* restrict w_,
+                                               const {scalar_type}* restrict c,
+                                               const {geom_type}* restrict coordinate_dofs_,
+                                               const int* restrict entity_local_index,
+                                               const uint8_t* restrict quadrature_permutation,
+                                               void* custom_data)
+{{
+{stats_begin}
+{vector_arguments}
+{tabulate_tensor}
+{stats_end}
+}}
+"""
+
+action_kernel = """
+void tabulate_action_{factory_name}({scalar_type}* restrict y,
+                                    const {scalar_type}* restrict x,
+                                    const {scalar_type}* restrict w,
+                                    const {scalar_type}* restrict c,
+                                    const {geom_type}* restrict coordinate_dofs,
+                                    const int* restrict entity_local_index,
+                                    const uint8_t* restrict quadrature_permutation,
+                                    void* custom_data)
+{{
+{tabulate_action}
+}}
+"""
+
+geometry_kernel = """
+void tabulate_tensor_geometry_{factory_name}({scalar_type}* restrict A,
+                                             const {scalar_type}* restrict w,
+                                             const {scalar_type}* restrict c,
+                                             const {geom_type}* restrict coordinate_dofs,
+                                             const {geom_type}* restrict geometry,
+                                             const int* restrict entity_local_index,
+                                             const uint8_t* restrict quadrature_permutation,
+                                             void* custom_data)
+{{
+{tabulate_tensor}
+}}
+"""
+
+gather_kernel = """
+void tabulate_tensor_gather_{factory_name}({scalar_type}* restrict A,
+                                           const {scalar_type}* const* restrict w,
+                                           const int32_t* const* restrict dofmaps,
+                                           const {scalar_type}* restrict c,
+                                           const {geom_type}* restrict coordinate_dofs,
+                                           const int* restrict entity_local_index,
+                                           const uint8_t* restrict quadrature_permutation,
+                                           void* custom_data)
+{{
+{tabulate_tensor}
+}}
+"""
+
+scatter_kernel = """
+void tabulate_tensor_scatter_{factory_name}({scalar_type}* restrict values,
+                                            const int64_t* restrict positions,
+                                            const {scalar_type}* restrict w,
+                                            const {scalar_type}* restrict c,
+                                            const {geom_type}* restrict coordinate_dofs,
+                                            const int* restrict entity_local_index,
+                                            const uint8_t* restrict quadrature_permutation,
+                                            void* custom_data)
+{{
+{tabulate_tensor}
+}}
+"""
+
+permuted_kernel = """
+void tabulate_tensor_{factory_name}_{perm0}_{perm1}({scalar_type}* restrict A,
+                                    const {scalar_type}* restrict w,
+                                    const {scalar_type}* restrict c,
+                                    const {geom_type}* restrict coordinate_dofs,
+                                    const int* restrict entity_local_index,
+                                    const uint8_t* restrict quadrature_permutation,
+                                    void* custom_data)
+{{
+{tabulate_tensor}
+}}
+"""
+
+permuted_kernels = """
+static ufcx_tabulate_tensor_{np_scalar_type}* const
+    tabulate_tensor_permuted_{factory_name}[{size}] =
+{{
+  {kernels}
+}};
+"""
+
+fused_declaration = """
+extern ufcx_fused_integral {factory_name};
+"""
+
+fused_kernel = """
+void tabulate_tensor_{factory_name}({scalar_type}* const* restrict A,
+                                    const {scalar_type}* const* restrict w,
+                                    const {scalar_type}* const* restrict c,
+                                    const {geom_type}* restrict coordinate_dofs,
+                                    const int* restrict entity_local_index,
+                                    const uint8_t* restrict quadrature_permutation,
+                                    void* custom_data)
+{{
+{arguments}
+{tabulate_tensor}
+}}
+"""
+
+fused_factory = """
+// Code for fused integral {factory_name}
+{kernel}
+static ufcx_integral* integrals_{factory_name}[{num_integrals}] = {{{integrals}}};
+
+ufcx_fused_integral {factory_name} =
+{{
+  .num_integrals = {num_integrals},
+  .integrals = integrals_{factory_name},
   {tabulate_tensor_float32}
   {tabulate_tensor_float64}
   {tabulate_tensor_complex64}
   {tabulate_tensor_complex128}
-  .needs_facet_permutations = {needs_facet_permutations},
-  .coordinate_element_hash = {coordinate_element_hash},
-  .domain = {domain},
+  .flops_per_call = {flops_per_call},
 }};
-
-// End of code for integral {factory_name}
+{isa_dispatch}
+// End of code for fused integral {factory_name}
 """
@@ -0,0 +1 @@
+"""Generation of CUDA and HIP device code."""
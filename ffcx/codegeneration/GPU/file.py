@@ -0,0 +1,60 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx. (https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Generate a file of device code."""
+
+import logging
+import pprint
+import textwrap
+
+import numpy as np
+
+from ffcx import __version__ as FFCX_VERSION
+from ffcx.codegeneration import __version__ as UFC_VERSION
+from ffcx.codegeneration.GPU import file_template
+from ffcx.codegeneration.GPU.gpu_implementation import GPUFormatter, constant_memory_size
+from ffcx.codegeneration.table_pool import TablePool
+from ffcx.codegeneration.utils import dtype_to_scalar_dtype, dtype_with_precision
+
+logger = logging.getLogger("ffcx")
+
+
+def generator(options):
+    """Generate device code for file output."""
+    logger.info("Generating device code for file")
+
+    d = {"ffcx_version": FFCX_VERSION, "ufcx_version": UFC_VERSION}
+    d["options"] = textwrap.indent(pprint.pformat(options), "//  ")
+    d["runtime_include"] = file_template.runtime_includes[options["gpu_backend"]]
+
+    code_pre = (
+        file_template.declaration_pre.format_map(d),
+        file_template.implementation_pre.format_map(d),
+    )
+    code_post = (
+        file_template.declaration_post.format_map(d),
+        file_template.implementation_post.format_map(d),
+    )
+    return code_pre, code_post
+
+
+def table_pool_generator(table_pool: TablePool, options):
+    """Generate the file-scope declarations of the tables in a table pool.
+
+    The tables are placed in constant memory, which is cached and
+    broadcasts the values read by all threads of a warp, if they fit
+    in it, and in global memory otherwise.
+    """
+    dtype = np.dtype(options["scalar_type"])
+    table_dtype = dtype_to_scalar_dtype(dtype_with_precision(dtype, options["compute_precision"]))
+    size = sum(decl.values.size for decl in table_pool.declarations) * table_dtype.itemsize
+    memory_space = "__constant__" if size <= constant_memory_size else "__device__"
+    CF = GPUFormatter(dtype, memory_space=memory_space, table_dtype=table_dtype)
+    implementation = "".join(CF.c_format(decl) for decl in table_pool.declarations)
+    if implementation:
+        implementation = file_template.table_pool.format(
+            memory_space=memory_space.strip("_"), tables=implementation
+        )
+    return "", implementation
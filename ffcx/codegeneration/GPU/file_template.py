@@ -0,0 +1,55 @@
+# Code generation format strings for UFC (Unified Form-assembly Code)
+# This code is released into the public domain.
+#
+# The FEniCS Project (http://www.fenicsproject.org/) 2025
+"""Code generation strings for a file of device code."""
+
+declaration_pre = """
+// This code conforms with the UFC specification version {ufcx_version}
+// and was automatically generated by FFCx version {ffcx_version}.
+//
+// This code was generated with the following options:
+//
+{options}
+
+#pragma once
+#include <ufcx_gpu.h>
+
+#ifdef __cplusplus
+extern "C" {{
+#endif
+
+"""
+
+declaration_post = """
+#ifdef __cplusplus
+}}
+#endif
+"""
+
+implementation_pre = """
+// This code conforms with the UFC specification version {ufcx_version}
+// and was automatically generated by FFCx version {ffcx_version}.
+//
+// This code was generated with the following options:
+//
+{options}
+{runtime_include}
+#include <math.h>
+#include <stdint.h>
+#include <ufcx_gpu.h>
+"""
+
+table_pool = """
+// Tables of basis function values and quadrature weights shared by the
+// kernels of this file, in {memory_space} memory
+{tables}
+"""
+
+implementation_post = ""
+
+# Headers of the runtime of each backend, included by nvcc implicitly
+runtime_includes = {"cuda": "", "hip": "#include <hip/hip_runtime.h>\n"}
+
+# Extensions of the source files of each backend
+extensions = {"cuda": "cu", "hip": "hip"}
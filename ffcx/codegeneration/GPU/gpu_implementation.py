@@ -0,0 +1,56 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx. (https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""CUDA and HIP implementation."""
+
+import typing
+
+import numpy as np
+import numpy.typing as npt
+
+from ffcx.codegeneration.C.c_implementation import CFormatter
+
+# Size in bytes of the constant memory of CUDA and HIP devices
+constant_memory_size = 65536
+
+
+class GPUFormatter(CFormatter):
+    """Formatter of device code.
+
+    The statements of device code are those of C, so only the
+    declarations of static tables differ, which may be placed in a
+    device memory space.
+    """
+
+    def __init__(
+        self,
+        dtype: npt.DTypeLike,
+        real_dtype: typing.Optional[npt.DTypeLike] = None,
+        memory_space: str = "",
+        table_dtype: typing.Optional[npt.DTypeLike] = None,
+    ) -> None:
+        """Initialise.
+
+        Args:
+            dtype: Type of scalar (L.DataType.SCALAR) variables.
+            real_dtype: Type of real (L.DataType.REAL) variables, the
+                real type of dtype if None.
+            memory_space: Memory space of static tables, e.g.
+                ``__constant__`` for tables at file scope, or "" for
+                tables in kernel bodies.
+            table_dtype: Type of static tables (L.DataType.TABLE), the
+                real type of dtype if None.
+        """
+        if np.issubdtype(dtype, np.complexfloating):
+            raise NotImplementedError("Device code is not supported for complex scalar types.")
+        super().__init__(dtype, real_dtype, table_dtype=table_dtype)
+        self.memory_space = memory_space
+
+    def format_array_decl(self, arr) -> str:
+        """Format an array declaration."""
+        code = super().format_array_decl(arr)
+        if arr.const and self.memory_space:
+            code = code.replace("static const ", f"static {self.memory_space} const ", 1)
+        return code
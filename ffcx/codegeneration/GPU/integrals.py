@@ -0,0 +1,99 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx. (https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Generate the device kernel of an integral."""
+
+import logging
+import re
+
+import basix
+
+from ffcx import profiling
+from ffcx.codegeneration.backend import FFCXBackend
+from ffcx.codegeneration.C.integrals import entity_sizes
+from ffcx.codegeneration.GPU import integrals_template as ufcx_integrals
+from ffcx.codegeneration.GPU.gpu_implementation import GPUFormatter
+from ffcx.codegeneration.integral_generator import IntegralGenerator
+from ffcx.codegeneration.utils import (
+    dtype_to_c_type,
+    dtype_to_scalar_dtype,
+    dtype_with_precision,
+)
+from ffcx.ir.representation import IntegralIR
+
+logger = logging.getLogger("ffcx")
+
+# Types of the per-entity arguments of the kernel
+_argument_types = {
+    "A": "{scalar_type}*",
+    "w": "const {scalar_type}*",
+    "coordinate_dofs": "const {geom_type}*",
+    "entity_local_index": "const int*",
+    "quadrature_permutation": "const uint8_t*",
+}
+
+
+def generator(ir: IntegralIR, domain: basix.CellType, options, table_pool=None):
+    """Generate the device kernel of an integral.
+
+    The kernel tabulates the element tensor of one entity per thread,
+    with the body of the C kernel tabulate_tensor.
+
+    Args:
+        ir: Intermediate representation of the integral.
+        domain: Cell type of the integration domain.
+        options: Options.
+        table_pool: Pool of tables shared by the kernels of the module,
+            or None to declare the tables in each kernel.
+    """
+    logger.info("Generating device code for integral:")
+    logger.info(f"--- type: {ir.expression.integral_type}")
+    logger.info(f"--- name: {ir.expression.name}")
+
+    factory_name = f"{ir.expression.name}_{domain.name}"
+    declaration = ufcx_integrals.declaration.format(factory_name=factory_name)
+
+    backend = FFCXBackend(ir, options)
+    ig = IntegralGenerator(ir, backend, table_pool)
+    with profiling.scope(ir.expression.name):
+        parts = ig.generate(domain)
+        with profiling.timer("gpu_format"):
+            CF = GPUFormatter(
+                options["scalar_type"],
+                table_dtype=dtype_with_precision(
+                    options["scalar_type"], options["compute_precision"]
+                ),
+            )
+            body = CF.c_format(parts)
+
+    scalar_type = options["scalar_type"]
+    types = {
+        "scalar_type": dtype_to_c_type(scalar_type),
+        "geom_type": dtype_to_c_type(dtype_to_scalar_dtype(scalar_type)),
+    }
+
+    # Pointers to the data of the entity of the thread, declared for the
+    # arguments used by the body only
+    sizes = entity_sizes(ir)
+    arguments = []
+    for name, size in sizes.items():
+        if re.search(rf"\b{name}\b", body) is None:
+            continue
+        offset = f" + entity * {size}" if size > 0 else ""
+        typename = _argument_types[name].format_map(types)
+        arguments.append(f"  {typename} __restrict__ {name} = {name}_{offset};")
+
+    implementation = ufcx_integrals.factory.format(
+        factory_name=factory_name,
+        arguments="\n".join(arguments),
+        tabulate_tensor=body,
+        tensor_size=sizes["A"],
+        coefficient_size=sizes["w"],
+        coordinate_dofs_size=sizes["coordinate_dofs"],
+        num_entity_local_indices=sizes["entity_local_index"],
+        num_quadrature_permutations=sizes["quadrature_permutation"],
+        **types,
+    )
+    return declaration, implementation
@@ -0,0 +1,44 @@
+# Code generation format strings for UFC (Unified Form-assembly Code)
+# This code is released into the public domain.
+#
+# The FEniCS Project (http://www.fenicsproject.org/) 2025
+"""Code generation strings for the device kernel of an integral."""
+
+declaration = """
+extern ufcx_gpu_integral {factory_name}_gpu;
+"""
+
+factory = """
+// Device kernel for integral {factory_name}
+extern "C" __global__ void tabulate_tensor_{factory_name}_gpu(
+    {scalar_type}* __restrict__ A_,
+    const {scalar_type}* __restrict__ w_,
+    const {scalar_type}* __restrict__ c,
+    const {geom_type}* __restrict__ coordinate_dofs_,
+    const int* __restrict__ entity_local_index_,
+    const uint8_t* __restrict__ quadrature_permutation_,
+    int num_entities)
+{{
+  const int entity = blockIdx.x * blockDim.x + threadIdx.x;
+  if (entity >= num_entities)
+    return;
+{arguments}
+{tabulate_tensor}
+}}
+
+extern "C"
+{{
+ufcx_gpu_integral {factory_name}_gpu =
+{{
+  /* .name = */ "{factory_name}",
+  /* .tabulate_tensor = */ (const void*)tabulate_tensor_{factory_name}_gpu,
+  /* .tensor_size = */ {tensor_size},
+  /* .coefficient_size = */ {coefficient_size},
+  /* .coordinate_dofs_size = */ {coordinate_dofs_size},
+  /* .num_entity_local_indices = */ {num_entity_local_indices},
+  /* .num_quadrature_permutations = */ {num_quadrature_permutations}
+}};
+}}
+
+// End of code for integral {factory_name}
+"""
@@ -40,6 +40,8 @@ class FFCXBackendAccess:
             ufl.coefficient.Coefficient: self.coefficient,
             ufl.constant.Constant: self.constant,
             ufl.geometry.Jacobian: self.jacobian,
+            ufl.geometry.JacobianDeterminant: self.jacobian_determinant,
+            ufl.geometry.JacobianInverse: self.jacobian_inverse,
             ufl.geometry.CellCoordinate: self.cell_coordinate,
             ufl.geometry.FacetCoordinate: self.facet_coordinate,
             ufl.geometry.CellVertices: self.cell_vertices,
@@ -99,7 +101,7 @@ class FFCXBackendAccess:
             # f = 1.0 * f_{begin}, just return direct reference to dof
             # array at dof begin (if mt is restricted, begin contains
             # cell offset)
-            return self.symbols.coefficient_dof_access(mt.terminal, begin)
+            return self.symbols.coefficient_dof_access(mt.terminal, 0, tabledata.block_size, begin)
         else:
             # Return symbol, see definitions for computation
             return self.symbols.coefficient_value(mt)
@@ -213,6 +215,14 @@ class FFCXBackendAccess:
             raise RuntimeError("Not expecting average of Jacobian.")
         return self.symbols.J_component(mt)
 
+    def jacobian_determinant(self, mt, tabledata, num_points):
+        """Access a jacobian determinant."""
+        return self.symbols.detJ(mt)
+
+    def jacobian_inverse(self, mt, tabledata, num_points):
+        """Access a jacobian inverse component."""
+        return self.symbols.K_component(mt)
+
     def reference_cell_volume(self, mt, tabledata, access):
         """Access a reference cell volume."""
         cellname = ufl.domain.extract_unique_domain(mt.terminal).ufl_cell().cellname()
@@ -437,15 +447,15 @@ class FFCXBackendAccess:
         if tabledata.is_piecewise:
             iq_global_index = L.LiteralInt(0)
 
-        # FIXME: Hopefully tabledata is not permuted when applying sum
-        # factorization
         if tabledata.is_permuted:
             qp = self.symbols.quadrature_permutation[0]
             if restriction == "-":
                 qp = self.symbols.quadrature_permutation[1]
 
-        if dof_index.dim == 1 and quadrature_index.dim == 1:
-            symbols += [L.Symbol(tabledata.name, dtype=L.DataType.REAL)]
+        # Tables that are not split into tensor factors are tabulated at
+        # the points of the flattened rule, tensor product or not
+        if not tabledata.has_tensor_factorisation:
+            symbols += [self.symbols.element_tables[tabledata.name]]
             return self.symbols.element_tables[tabledata.name][qp][entity][iq_global_index][
                 ic_global_index
             ], symbols
@@ -457,6 +467,6 @@ class FFCXBackendAccess:
                 iq_i = quadrature_index.local_index(i)
                 ic_i = dof_index.local_index(i)
                 table = self.symbols.element_tables[factor.name][qp][entity][iq_i][ic_i]
-                symbols += [L.Symbol(factor.name, dtype=L.DataType.REAL)]
+                symbols += [self.symbols.element_tables[factor.name]]
                 FE.append(table)
             return L.Product(FE), symbols
@@ -0,0 +1,314 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx.(https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Multi-process safe cache of JIT compiled modules.
+
+Compiled modules are stored under a name derived from a hash of their
+generated source (the content name). A small index file maps the
+signature of the compiled UFL objects to the content name, so that a
+cache hit only needs to read the index and load the module, without
+generating any code.
+
+Modules are built in a private temporary directory and published into
+the cache directory with an atomic rename, so other processes either see
+a complete module or none at all. Builds of the same signature are
+serialised with a file lock, which the operating system releases if the
+holding process dies. Least recently used modules are evicted when the
+total size of the cache exceeds a limit, together with the objects of
+split translation units that no remaining module links.
+"""
+
+from __future__ import annotations
+
+import contextlib
+import hashlib
+import importlib.machinery
+import importlib.util
+import logging
+import os
+import tempfile
+import time
+import typing
+from pathlib import Path
+
+if os.name == "nt":
+    import msvcrt
+else:
+    import fcntl
+
+logger = logging.getLogger("ffcx")
+
+
+def content_hash(*parts: str) -> str:
+    """Hash of the generated source and build inputs of a module."""
+    h = hashlib.sha1()
+    for part in parts:
+        h.update(part.encode("utf-8"))
+        h.update(b"\0")
+    return h.hexdigest()
+
+
+def _try_lock(f: typing.IO) -> bool:
+    """Try to take an exclusive lock on an open file without blocking."""
+    try:
+        if os.name == "nt":
+            f.seek(0)
+            msvcrt.locking(f.fileno(), msvcrt.LK_NBLCK, 1)
+        else:
+            fcntl.lockf(f, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        return True
+    except BlockingIOError:
+        return False
+    except PermissionError:
+        # Raised instead of BlockingIOError on some platforms
+        return False
+
+
+def _unlock(f: typing.IO) -> None:
+    if os.name == "nt":
+        f.seek(0)
+        msvcrt.locking(f.fileno(), msvcrt.LK_UNLCK, 1)
+    else:
+        fcntl.lockf(f, fcntl.LOCK_UN)
+
+
+class ModuleCache:
+    """Cache of compiled CFFI modules in a directory."""
+
+    def __init__(
+        self, cache_dir: Path, timeout: float = 10, size_limit: typing.Optional[int] = None
+    ):
+        """Initialise.
+
+        Args:
+            cache_dir: Cache directory, created if it does not exist.
+            timeout: Maximum time (seconds) to wait for another process
+                building the same module.
+            size_limit: Maximum total size (bytes) of the compiled
+                modules in the cache. No limit if ``None``.
+        """
+        self.cache_dir = Path(cache_dir)
+        self.timeout = timeout
+        self.size_limit = size_limit
+        self.cache_dir.mkdir(exist_ok=True, parents=True)
+
+    def _index_filename(self, name: str) -> Path:
+        return self.cache_dir.joinpath(name + ".index")
+
+    def _lock_filename(self, name: str) -> Path:
+        return self.cache_dir.joinpath(name + ".lock")
+
+    def _units_filename(self, name: str) -> Path:
+        return self.cache_dir.joinpath(name + ".units")
+
+    def _module_filenames(self, content_name: str) -> list[Path]:
+        return [
+            f
+            for f in self.cache_dir.glob(content_name + ".*")
+            if any(f.name.endswith(s) for s in importlib.machinery.EXTENSION_SUFFIXES)
+        ]
+
+    def load(self, name: str):
+        """Load a published module by signature name.
+
+        Returns:
+            The loaded module, or ``None`` if not in the cache.
+        """
+        try:
+            content_name = self._index_filename(name).read_text().strip()
+        except FileNotFoundError:
+            return None
+        return self.load_content(content_name)
+
+    def load_content(self, content_name: str):
+        """Load a published module by content name.
+
+        Returns:
+            The loaded module, or ``None`` if not in the cache.
+        """
+        filenames = self._module_filenames(content_name)
+        if len(filenames) == 0:
+            return None
+
+        # Mark as recently used
+        for f in filenames:
+            with contextlib.suppress(OSError):
+                os.utime(f)
+
+        finder = importlib.machinery.FileFinder(
+            str(self.cache_dir),
+            (importlib.machinery.ExtensionFileLoader, importlib.machinery.EXTENSION_SUFFIXES),
+        )
+        finder.invalidate_caches()
+        spec = finder.find_spec(content_name)
+        if spec is None:
+            # Evicted by another process in the meantime
+            return None
+        module = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(module)  # type: ignore
+        logger.info(f"Loaded JIT module {content_name} from cache")
+        return module
+
+    @contextlib.contextmanager
+    def lock(self, name: str):
+        """Hold the exclusive build lock of a signature name.
+
+        Raises:
+            TimeoutError: If the lock is not acquired within the timeout.
+        """
+        with open(self._lock_filename(name), "a+") as f:
+            deadline = time.monotonic() + self.timeout
+            delay = 0.01
+            try:
+                while not _try_lock(f):
+                    if time.monotonic() > deadline:
+                        raise TimeoutError(
+                            f"Timed out waiting for another process compiling JIT module {name}. "
+                            "Try increasing the timeout option."
+                        )
+                    time.sleep(delay)
+                    delay = min(2 * delay, 1.0)
+                locked = True
+            except OSError as e:
+                # File system without lock support (e.g. some network file
+                # systems). Publishing is still atomic, only the build may be
+                # duplicated.
+                logger.warning(f"Unable to lock JIT cache, proceeding without lock: {e}")
+                locked = False
+            try:
+                yield
+            finally:
+                if locked:
+                    _unlock(f)
+
+    def build_dir(self):
+        """Private directory in the cache file system to build a module in."""
+        return tempfile.TemporaryDirectory(dir=self.cache_dir, prefix=".build-")
+
+    def publish(self, content_name: str, build_dir: Path) -> None:
+        """Publish a module built in ``build_dir``."""
+        for f in Path(build_dir).glob(content_name + ".*"):
+            if f.is_file() and f.suffix != ".o":
+                os.replace(f, self.cache_dir.joinpath(f.name))
+
+    def write_index(self, name: str, content_name: str) -> None:
+        """Index a published module under a signature name."""
+        self._write(self._index_filename(name), content_name)
+
+    def write_units(self, name: str, unit_names: list[str]) -> None:
+        """Record the translation units linked into the module of a signature name.
+
+        Must be called while holding the build lock of the signature,
+        before the units are compiled, so that the units of a build in
+        progress are not evicted.
+        """
+        self._write(self._units_filename(name), "\n".join(unit_names))
+
+    def _write(self, filename: Path, text: str) -> None:
+        fd, tmp_name = tempfile.mkstemp(dir=self.cache_dir, suffix=".tmp")
+        with os.fdopen(fd, "w") as f:
+            f.write(text)
+        os.replace(tmp_name, filename)
+
+    def evict(self) -> None:
+        """Remove least recently used entries until the cache size is within the limit.
+
+        The size of the cache is that of the published modules and of
+        the source and object files of split translation units. Modules
+        are evicted together with the index, units and lock files of the
+        signatures that refer to them. Units are only evicted once no
+        remaining module, or build in progress, links them. Other files
+        in the cache directory are kept.
+        """
+        if self.size_limit is None:
+            return
+
+        # Group the files of each module and unit by name, ignoring
+        # builds in progress
+        entries: dict[str, list[os.stat_result]] = {}
+        files: dict[str, list[Path]] = {}
+        for f in self.cache_dir.iterdir():
+            if f.name.startswith(".") or f.suffix in (".index", ".lock", ".tmp", ".units"):
+                continue
+            with contextlib.suppress(OSError):
+                stem = f.name.split(".")[0]
+                entries.setdefault(stem, []).append(f.stat())
+                files.setdefault(stem, []).append(f)
+        modules = {
+            stem
+            for stem, fs in files.items()
+            if any(f.name.endswith(s) for f in fs for s in importlib.machinery.EXTENSION_SUFFIXES)
+        }
+        units = {
+            stem
+            for stem, fs in files.items()
+            if stem not in modules and any(f.suffix in (".c", ".o", ".obj") for f in fs)
+        }
+
+        # Signature names indexing each module
+        signatures: dict[str, list[str]] = {}
+        indexed = set()
+        for f in self.cache_dir.glob("*.index"):
+            with contextlib.suppress(OSError):
+                signatures.setdefault(f.read_text().strip(), []).append(f.stem)
+                indexed.add(f.stem)
+
+        # Units linked by the module of each signature. A signature
+        # without index is being built, unless its build failed.
+        signature_units: dict[str, list[str]] = {}
+        references: dict[str, set[str]] = {}
+        for f in self.cache_dir.glob("*.units"):
+            if f.stem not in indexed and not self._is_building(f.stem):
+                self._remove_signature(f.stem)
+                continue
+            with contextlib.suppress(OSError):
+                signature_units[f.stem] = f.read_text().split()
+                for unit in signature_units[f.stem]:
+                    references.setdefault(unit, set()).add(f.stem)
+
+        def last_used(stem: str) -> float:
+            return max(s.st_mtime for s in entries[stem])
+
+        size = sum(s.st_size for stem in modules | units for s in entries[stem])
+        candidates = modules | {stem for stem in units if not references.get(stem)}
+        while size > self.size_limit and candidates:
+            stem = min(candidates, key=last_used)
+            candidates.remove(stem)
+            logger.info(f"Evicting {stem} from JIT cache")
+            for f in files[stem]:
+                with contextlib.suppress(OSError):
+                    f.unlink()
+            size -= sum(s.st_size for s in entries[stem])
+            for name in signatures.get(stem, []):
+                self._remove_signature(name)
+                for unit in signature_units.get(name, []):
+                    references[unit].discard(name)
+                    if unit in units and not references[unit]:
+                        candidates.add(unit)
+            units.discard(stem)
+
+    def _is_building(self, name: str) -> bool:
+        """Whether another process holds the build lock of a signature name."""
+        try:
+            with open(self._lock_filename(name), "r+") as f:
+                if _try_lock(f):
+                    _unlock(f)
+                    return False
+                return True
+        except FileNotFoundError:
+            return False
+
+    def _remove_signature(self, name: str) -> None:
+        """Remove the index, units and lock files of a signature name, unless it is being built."""
+        with contextlib.suppress(OSError):
+            self._index_filename(name).unlink()
+        with contextlib.suppress(OSError):
+            self._units_filename(name).unlink()
+        with contextlib.suppress(OSError), open(self._lock_filename(name), "a+") as f:
+            if _try_lock(f):
+                try:
+                    self._lock_filename(name).unlink()
+                finally:
+                    _unlock(f)
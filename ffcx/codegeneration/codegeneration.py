@@ -19,9 +19,15 @@ import numpy.typing as npt
 
 from ffcx.codegeneration.C.expressions import generator as expression_generator
 from ffcx.codegeneration.C.file import generator as file_generator
+from ffcx.codegeneration.C.file import table_pool_generator
 from ffcx.codegeneration.C.form import generator as form_generator
+from ffcx.codegeneration.C.integrals import fused_generator as fused_integral_generator
 from ffcx.codegeneration.C.integrals import generator as integral_generator
-from ffcx.ir.representation import DataIR
+from ffcx.codegeneration.GPU.file import generator as gpu_file_generator
+from ffcx.codegeneration.GPU.file import table_pool_generator as gpu_table_pool_generator
+from ffcx.codegeneration.GPU.integrals import generator as gpu_integral_generator
+from ffcx.codegeneration.table_pool import TablePool
+from ffcx.ir.representation import DataIR, IntegralIR
 
 logger = logging.getLogger("ffcx")
 
@@ -29,10 +35,11 @@ logger = logging.getLogger("ffcx")
 class CodeBlocks(typing.NamedTuple):
     """Storage of code blocks of the form (declaration, implementation).
 
-    Blocks for integrals, forms and expressions, and start and end of file output
+    Blocks for shared tables, integrals, forms and expressions, and start and end of file output
     """
 
     file_pre: list[tuple[str, str]]
+    tables: list[tuple[str, str]]
     integrals: list[tuple[str, str]]
     forms: list[tuple[str, str]]
     expressions: list[tuple[str, str]]
@@ -40,17 +47,40 @@ class CodeBlocks(typing.NamedTuple):
 
 
 def generate_code(
-    ir: DataIR, options: dict[str, typing.Union[int, float, npt.DTypeLike]]
+    ir: DataIR,
+    options: dict[str, typing.Union[int, float, npt.DTypeLike]],
+    code_integrals: typing.Optional[list[tuple[str, str]]] = None,
+    table_pool: typing.Optional[TablePool] = None,
 ) -> CodeBlocks:
-    """Generate code blocks from intermediate representation."""
+    """Generate code blocks from intermediate representation.
+
+    Args:
+        ir: Intermediate representation.
+        options: Options.
+        code_integrals: Code of the integrals, if generated separately
+            from their IR (see `ffcx.parallel`), otherwise the code of
+            the integrals of ir is generated.
+        table_pool: Pool of the tables used by code_integrals.
+    """
     logger.info(79 * "*")
     logger.info("Compiler stage 3: Generating code")
     logger.info(79 * "*")
 
-    code_integrals = [
-        integral_generator(integral_ir, domain, options)
-        for integral_ir in ir.integrals
-        for domain in set(i[0] for i in integral_ir.expression.integrand.keys())
+    # Tables of all integrals are declared once at file scope
+    if table_pool is None:
+        table_pool = TablePool(options["table_rtol"], options["table_atol"])
+    if code_integrals is None:
+        code_integrals = [
+            integral_generator(integral_ir, domain, options, table_pool)
+            for integral_ir in ir.integrals
+            for domain in integral_domains(integral_ir)
+        ]
+    else:
+        code_integrals = list(code_integrals)
+    code_integrals += [
+        fused_integral_generator(fused_ir, domain, options, table_pool)
+        for fused_ir in ir.fused_integrals
+        for domain in set(i[0] for i in fused_ir.integrals[0].expression.integrand.keys())
     ]
     code_forms = [form_generator(form_ir, options) for form_ir in ir.forms]
     code_expressions = [
@@ -59,8 +89,48 @@ def generate_code(
     code_file_pre, code_file_post = file_generator(options)
     return CodeBlocks(
         file_pre=[code_file_pre],
+        tables=[table_pool_generator(table_pool, options)],
         integrals=code_integrals,
         forms=code_forms,
         expressions=code_expressions,
         file_post=[code_file_post],
     )
+
+
+def generate_gpu_code(
+    ir: DataIR, options: dict[str, typing.Union[int, float, npt.DTypeLike]]
+) -> CodeBlocks:
+    """Generate code blocks of the device kernels of the integrals of an IR.
+
+    The blocks of forms and expressions, which have no device code, are
+    empty. Custom integrals are skipped.
+
+    Args:
+        ir: Intermediate representation.
+        options: Options, with gpu_backend the language of the code.
+    """
+    logger.info(79 * "*")
+    logger.info(f"Compiler stage 3: Generating {options['gpu_backend']} device code")
+    logger.info(79 * "*")
+
+    table_pool = TablePool(options["table_rtol"], options["table_atol"])
+    code_integrals = [
+        gpu_integral_generator(integral_ir, domain, options, table_pool)
+        for integral_ir in ir.integrals
+        if integral_ir.expression.integral_type != "custom"
+        for domain in integral_domains(integral_ir)
+    ]
+    code_file_pre, code_file_post = gpu_file_generator(options)
+    return CodeBlocks(
+        file_pre=[code_file_pre],
+        tables=[gpu_table_pool_generator(table_pool, options)],
+        integrals=code_integrals,
+        forms=[],
+        expressions=[],
+        file_post=[code_file_post],
+    )
+
+
+def integral_domains(integral_ir: IntegralIR) -> set:
+    """Cell types of the quadrature rules of an integral, one kernel is generated for each."""
+    return set(i[0] for i in integral_ir.expression.integrand.keys())
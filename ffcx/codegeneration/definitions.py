@@ -11,6 +11,7 @@ from typing import Union
 import ufl
 
 import ffcx.codegeneration.lnodes as L
+from ffcx.codegeneration.geometry import affine_geometry_offsets, jacobian_determinant_inverse
 from ffcx.definitions import entity_types
 from ffcx.ir.analysis.modified_terminals import ModifiedTerminal
 from ffcx.ir.elementtables import UniqueTableReferenceT
@@ -64,7 +65,9 @@ class FFCXBackendDefinitions:
         # called, depending on the first argument type.
         self.handler_lookup = {
             ufl.coefficient.Coefficient: self.coefficient,
-            ufl.geometry.Jacobian: self._define_coordinate_dofs_lincomb,
+            ufl.geometry.Jacobian: self.jacobian,
+            ufl.geometry.JacobianDeterminant: self.jacobian_determinant_inverse,
+            ufl.geometry.JacobianInverse: self.jacobian_determinant_inverse,
             ufl.geometry.SpatialCoordinate: self.spatial_coordinate,
             ufl.constant.Constant: self.pass_through,
             ufl.geometry.CellVertices: self.pass_through,
@@ -149,8 +152,9 @@ class FFCXBackendDefinitions:
 
         # Get access to element table
         FE, tables = self.access.table_access(tabledata, self.entity_type, mt.restriction, iq, ic)
+        dof = self.symbols.element_dof(tabledata, ic.global_index)
         dof_access: L.ArrayAccess = self.symbols.coefficient_dof_access(
-            mt.terminal, (ic.global_index) * bs + begin
+            mt.terminal, dof, bs, begin
         )
 
         declaration: list[L.Declaration] = [L.VariableDecl(access, 0.0)]
@@ -159,6 +163,8 @@ class FFCXBackendDefinitions:
 
         name = type(mt.terminal).__name__
         input = [dof_access.array, *tables]
+        if isinstance(dof, L.ArrayAccess):
+            input.append(dof.array)
         output = [access]
         annotations = [L.Annotation.fuse]
 
@@ -256,8 +262,66 @@ class FFCXBackendDefinitions:
         quadrature_rule: QuadratureRule,
         access: L.Symbol,
     ) -> Union[L.Section, list]:
-        """Return definition code for the Jacobian of x(X)."""
-        return self._define_coordinate_dofs_lincomb(mt, tabledata, quadrature_rule, access)
+        """Return definition code for the Jacobian of x(X).
+
+        If the geometry is precomputed, the constant Jacobian of an affine
+        cell is read from it, see `affine_geometry_offsets`.
+        """
+        geometry = self.symbols.precomputed_geometry
+        if geometry is None or mt.local_derivatives or mt.averaged:
+            return self._define_coordinate_dofs_lincomb(mt, tabledata, quadrature_rule, access)
+
+        domain = ufl.domain.extract_unique_domain(mt.terminal)
+        gdim, tdim = domain.geometric_dimension(), domain.topological_dimension()
+        size = affine_geometry_offsets(gdim, tdim)[2]
+        offset = size if mt.restriction == "-" else 0
+        declaration = [L.VariableDecl(access, geometry[offset + mt.flat_component])]
+        annotations = [L.Annotation.fuse]
+        return L.Section("Jacobian", [], declaration, [geometry], [access], annotations)
+
+    def jacobian_determinant_inverse(
+        self,
+        mt: ModifiedTerminal,
+        tabledata: UniqueTableReferenceT,
+        quadrature_rule: QuadratureRule,
+        access: L.Symbol,
+    ) -> Union[L.Section, list]:
+        """Return definition code for detJ or K of an affine simplex cell.
+
+        These are only kept by the analysis if the geometry kernels are
+        generated. They are read from the precomputed geometry, or else
+        computed from the vertices of the cell.
+        """
+        if mt.local_derivatives or mt.averaged:
+            raise RuntimeError("Not expecting derivatives or averages of detJ or K.")
+
+        domain = ufl.domain.extract_unique_domain(mt.terminal)
+        gdim, tdim = domain.geometric_dimension(), domain.topological_dimension()
+        is_determinant = isinstance(mt.terminal, ufl.geometry.JacobianDeterminant)
+        geometry = self.symbols.precomputed_geometry
+        if geometry is not None:
+            detJ_offset, K_offset, size = affine_geometry_offsets(gdim, tdim)
+            offset = size if mt.restriction == "-" else 0
+            offset += detJ_offset if is_determinant else K_offset
+            value = geometry[offset + mt.flat_component]
+            input = geometry
+        else:
+            J = [
+                [
+                    self.symbols.domain_dof_access(j + 1, i, gdim, tdim + 1, mt.restriction)
+                    - self.symbols.domain_dof_access(0, i, gdim, tdim + 1, mt.restriction)
+                    for j in range(tdim)
+                ]
+                for i in range(gdim)
+            ]
+            detJ, K = jacobian_determinant_inverse(J)
+            value = detJ if is_determinant else K[mt.component[0]][mt.component[1]]
+            input = self.symbols.coordinate_dofs
+
+        name = type(mt.terminal).__name__
+        declaration = [L.VariableDecl(access, value)]
+        annotations = [L.Annotation.fuse]
+        return L.Section(name, [], declaration, [input], [access], annotations)
 
     def pass_through(
         self,
@@ -7,7 +7,7 @@
 
 import collections
 import logging
-from itertools import product
+from itertools import count, product
 from typing import Any
 
 import ufl
@@ -16,6 +16,7 @@ import ffcx.codegeneration.lnodes as L
 from ffcx.codegeneration import geometry
 from ffcx.codegeneration.backend import FFCXBackend
 from ffcx.codegeneration.lnodes import LNode
+from ffcx.codegeneration.optimizer import hoist_loop_invariants, optimize_kernel
 from ffcx.ir.representation import ExpressionIR
 
 logger = logging.getLogger("ffcx")
@@ -35,6 +36,8 @@ class ExpressionGenerator:
         self._ufl_names: set[Any] = set()
         self.symbol_counters: collections.defaultdict[Any, int] = collections.defaultdict(int)
         self.shared_symbols: dict[Any, Any] = {}
+        # Counter for the names of values hoisted out of the argument loops
+        self.temp_counter = count()
         self.quadrature_rule = next(iter(self.ir.expression.integrand.keys()))
 
     def generate(self):
@@ -57,7 +60,24 @@ class ExpressionGenerator:
         parts += all_preparts
         parts += all_quadparts
 
-        return L.StatementList(parts)
+        return L.StatementList(optimize_kernel(parts))
+
+    def generate_batch(self):
+        """Generate the kernel for a batch of cells, split into tables and body.
+
+        Returns:
+            The static tables, declared once for the whole batch, and the
+            body evaluating the expression on one cell of the batch.
+        """
+        tables = self.generate_element_tables()
+        tables += self.generate_geometry_tables()
+
+        body = self.generate_piecewise_partition()
+        preparts, quadparts = self.generate_quadrature_loop()
+        body += preparts
+        body += quadparts
+
+        return L.StatementList(tables), L.StatementList(optimize_kernel(body))
 
     def generate_geometry_tables(self):
         """Generate static tables of geometry data."""
@@ -102,7 +122,7 @@ class ExpressionGenerator:
 
         for name in table_names:
             table = tables[name]
-            symbol = L.Symbol(name, dtype=L.DataType.REAL)
+            symbol = L.Symbol(name, dtype=L.DataType.TABLE)
             self.backend.symbols.element_tables[name] = symbol
             decl = L.ArrayDecl(symbol, sizes=table.shape, values=table, const=True)
             parts += [decl]
@@ -280,8 +300,10 @@ class ExpressionGenerator:
                 body.append(L.AssignAdd(A[multi_index], Brhs))
 
             for i in reversed(range(block_rank)):
-                body = L.ForRange(B_indices[i + 1], 0, blockdims[i], body=body)
-            quadparts += [body]
+                body = [L.ForRange(B_indices[i + 1], 0, blockdims[i], body=body)]
+            if block_rank > 0:
+                body = hoist_loop_invariants(body[0], self.temp_counter)
+            quadparts += body
 
         return preparts, quadparts
 
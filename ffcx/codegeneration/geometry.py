@@ -135,3 +135,59 @@ def facet_orientation(tablename, cellname):
     out = basix.cell.facet_orientations(celltype)
     symbol = L.Symbol(f"{cellname}_{tablename}", dtype=L.DataType.REAL)
     return L.ArrayDecl(symbol, values=np.asarray(out), const=True)
+
+
+def affine_geometry_offsets(gdim: int, tdim: int) -> tuple[int, int, int]:
+    """Offsets of detJ and K, and size of the precomputed geometry of an affine cell.
+
+    The geometry of each restriction holds the Jacobian J[gdim][tdim],
+    starting at 0, its determinant and the inverse K[tdim][gdim], all
+    row-major.
+    """
+    return gdim * tdim, gdim * tdim + 1, 2 * gdim * tdim + 1
+
+
+def jacobian_determinant_inverse(J):
+    """Determinant and inverse of the Jacobian of an affine cell.
+
+    For manifolds, with gdim > tdim, these are the pseudo-determinant
+    sqrt(det(J^T J)) and the pseudo-inverse (J^T J)^{-1} J^T, as in the
+    geometry lowering of UFL.
+    """
+    gdim, tdim = len(J), len(J[0])
+    if gdim == tdim:
+        A = J
+    else:
+        A = [
+            [L.Sum([J[k][i] * J[k][j] for k in range(gdim)]) for j in range(tdim)]
+            for i in range(tdim)
+        ]
+
+    if tdim == 1:
+        det = A[0][0]
+        adjugate = [[L.LiteralFloat(1.0)]]
+    elif tdim == 2:
+        det = A[0][0] * A[1][1] - A[0][1] * A[1][0]
+        adjugate = [[A[1][1], -A[0][1]], [-A[1][0], A[0][0]]]
+    elif tdim == 3:
+        cofactor = [
+            [
+                A[(i + 1) % 3][(j + 1) % 3] * A[(i + 2) % 3][(j + 2) % 3]
+                - A[(i + 1) % 3][(j + 2) % 3] * A[(i + 2) % 3][(j + 1) % 3]
+                for j in range(3)
+            ]
+            for i in range(3)
+        ]
+        det = L.Sum([A[0][j] * cofactor[0][j] for j in range(3)])
+        adjugate = [[cofactor[j][i] for j in range(3)] for i in range(3)]
+    else:
+        raise RuntimeError(f"Unexpected topological dimension {tdim}.")
+
+    inverse = [[L.Div(adjugate[i][j], det) for j in range(tdim)] for i in range(tdim)]
+    if gdim == tdim:
+        return det, inverse
+    K = [
+        [L.Sum([inverse[i][k] * J[j][k] for k in range(tdim)]) for j in range(gdim)]
+        for i in range(tdim)
+    ]
+    return L.MathFunction("sqrt", [det]), K
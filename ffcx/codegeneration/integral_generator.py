@@ -13,12 +13,13 @@ from numbers import Integral
 from typing import Any
 
 import basix
+import numpy as np
 import ufl
 
 import ffcx.codegeneration.lnodes as L
 from ffcx.codegeneration import geometry
 from ffcx.codegeneration.definitions import create_dof_index, create_quadrature_index
-from ffcx.codegeneration.optimizer import optimize
+from ffcx.codegeneration.optimizer import optimize, optimize_kernel
 from ffcx.ir.elementtables import piecewise_ttypes
 from ffcx.ir.integral import BlockDataT
 from ffcx.ir.representationutils import QuadratureRule
@@ -26,6 +27,23 @@ from ffcx.ir.representationutils import QuadratureRule
 logger = logging.getLogger("ffcx")
 
 
+def _staged_index(first: L.MultiIndex, second: L.MultiIndex, directions) -> L.MultiIndex:
+    """Multi-index with the entries of ``second`` in ``directions`` and of ``first`` otherwise."""
+    symbols, sizes = zip(
+        *[
+            (second.symbols[j], second.sizes[j]) if j in directions else (s, n)
+            for j, (s, n) in enumerate(zip(first.symbols, first.sizes))
+        ]
+    )
+    return L.MultiIndex(list(symbols), list(sizes))
+
+
+def _loop_index(index: L.MultiIndex) -> L.MultiIndex:
+    """Multi-index of the loops over ``index``, without its fixed entries."""
+    loops = [(s, n) for s, n in zip(index.symbols, index.sizes) if isinstance(s, L.Symbol)]
+    return L.MultiIndex([s for s, _ in loops], [n for _, n in loops])
+
+
 def extract_dtype(v, vops: list[Any]):
     """Extract dtype from ufl expression v and its operands."""
     dtypes = []
@@ -45,8 +63,16 @@ def extract_dtype(v, vops: list[Any]):
 class IntegralGenerator:
     """Integral generator."""
 
-    def __init__(self, ir, backend):
-        """Initialise."""
+    def __init__(self, ir, backend, table_pool=None):
+        """Initialise.
+
+        Args:
+            ir: Intermediate representation of the integral.
+            backend: Backend.
+            table_pool: Pool of static tables shared with the other
+                kernels of the module. Tables are declared inside the
+                kernel if None.
+        """
         # Store ir
         self.ir = ir
 
@@ -56,6 +82,8 @@ class IntegralGenerator:
         # - access: for accessing backend specific variables
         self.backend = backend
 
+        self.table_pool = table_pool
+
         # Set of operator names code has been generated for, used in the
         # end for selecting necessary includes
         self._ufl_names = set()
@@ -70,6 +98,12 @@ class IntegralGenerator:
         # variables
         self.symbol_counters = collections.defaultdict(int)
 
+        # Staged (sum factorised) contractions of each quadrature loop,
+        # placed before and after the loop, and their buffers by key
+        self.staged_preparts = collections.defaultdict(list)
+        self.staged_postparts = collections.defaultdict(list)
+        self.staged_buffers = {}
+
     def init_scopes(self):
         """Initialize variable scope dicts."""
         # Reset variables, separate sets for each quadrature rule
@@ -170,11 +204,15 @@ class IntegralGenerator:
                 # element tensor
                 all_quadparts += self.generate_quadrature_loop(rule, cell)
 
+        # Generate the tables of dofs of compressed element tables used
+        # in the quadrature loops
+        parts += self.generate_dofmap_tables()
+
         # Collect parts before, during, and after quadrature loops
         parts += all_preparts
         parts += all_quadparts
 
-        return L.StatementList(parts)
+        return L.StatementList(optimize_kernel(parts))
 
     def generate_quadrature_tables(self, domain: basix.CellType):
         """Generate static tables of quadrature points and weights."""
@@ -191,7 +229,11 @@ class IntegralGenerator:
             if domain == cell:
                 # Generate quadrature weights array
                 wsym = self.backend.symbols.weights_table(quadrature_rule)
-                parts += [L.ArrayDecl(wsym, values=quadrature_rule.weights, const=True)]
+                if self.table_pool is not None:
+                    symbol = self.table_pool.get(quadrature_rule.weights)
+                    self.backend.symbols.quadrature_weight_tables[wsym.name] = symbol
+                else:
+                    parts += [L.ArrayDecl(wsym, values=quadrature_rule.weights, const=True)]
 
         # Add leading comment if there are any tables
         parts = L.commented_code_list(parts, "Quadrature rules")
@@ -211,7 +253,7 @@ class IntegralGenerator:
         }
         cells: dict[Any, set[Any]] = {t: set() for t in ufl_geometry.keys()}  # type: ignore
 
-        for integrand in self.ir.expression.integrand.values():
+        for integrand in self.integrands():
             for attr in integrand["factorization"].nodes.values():
                 mt = attr.get("mt")
                 if mt is not None:
@@ -228,6 +270,10 @@ class IntegralGenerator:
 
         return parts
 
+    def integrands(self):
+        """Integrands of all quadrature rules of the generated kernel."""
+        return self.ir.expression.integrand.values()
+
     def generate_element_tables(self, domain: basix.CellType):
         """Generate static tables.
 
@@ -257,19 +303,58 @@ class IntegralGenerator:
         )
         return parts
 
+    def generate_dofmap_tables(self):
+        """Generate static tables of the dofs of compressed element tables.
+
+        Element tables with structurally zero columns are stored without
+        these columns, and the loops over their columns find the element
+        dofs in these tables. The staged contractions of facet tables
+        find the element dofs of their facet-local factors the same way.
+        """
+        parts = []
+        for dofmap, symbol in self.backend.symbols.element_dofmaps.items():
+            parts += [L.ArrayDecl(symbol, values=np.asarray(dofmap, dtype=np.int32), const=True)]
+        return L.commented_code_list(parts, "Dofs of the columns of compressed element tables")
+
     def declare_table(self, name, table):
         """Declare a table.
 
         If the dof dimensions of the table have dof rotations, apply
-        these rotations.
+        these rotations. Tables in the table pool are only referenced.
 
         """
-        table_symbol = L.Symbol(name, dtype=L.DataType.REAL)
+        if self.table_pool is not None:
+            self.backend.symbols.element_tables[name] = self.table_pool.get(table)
+            return []
+
+        table_symbol = L.Symbol(name, dtype=L.DataType.TABLE)
         self.backend.symbols.element_tables[name] = table_symbol
         return [L.ArrayDecl(table_symbol, values=table, const=True)]
 
     def generate_quadrature_loop(self, quadrature_rule: QuadratureRule, domain: basix.CellType):
         """Generate quadrature loop with for this quadrature_rule."""
+        code = self.generate_quadrature_loop_body(quadrature_rule, domain)
+
+        iq_symbol = self.backend.symbols.quadrature_loop_index
+        iq = create_quadrature_index(quadrature_rule, iq_symbol)
+
+        code = optimize(code, quadrature_rule)
+
+        preparts = L.commented_code_list(
+            self.staged_preparts[(domain, quadrature_rule)],
+            "Sum factorisation: interpolate coefficients to quadrature points, "
+            "and initialise quadrature sums",
+        )
+        postparts = L.commented_code_list(
+            self.staged_postparts[(domain, quadrature_rule)],
+            "Sum factorisation and quadrature sums: integrate against test functions",
+        )
+        return [*preparts, L.create_nested_for_loops([iq], code), *postparts]
+
+    def generate_quadrature_loop_body(
+        self, quadrature_rule: QuadratureRule, domain: basix.CellType
+    ) -> list[L.LNode]:
+        """Generate the sections of the body of the quadrature loop, before optimisation."""
         # Generate varying partition
         definitions, intermediates_0 = self.generate_varying_partition(quadrature_rule, domain)
 
@@ -293,13 +378,202 @@ class IntegralGenerator:
             intermediates_0 += [L.Assign(fw.symbol, fw.value)]
         intermediates = [L.Section("Intermediates", intermediates_0, declarations, inputs, output)]
 
-        iq_symbol = self.backend.symbols.quadrature_loop_index
-        iq = create_quadrature_index(quadrature_rule, iq_symbol)
+        return definitions + intermediates + tensor_comp
 
-        code = definitions + intermediates + tensor_comp
-        code = optimize(code, quadrature_rule)
+    def is_quadrature_invariant(self, blockdata, quadrature_rule) -> bool:
+        """Check if the argument factors of a block are the same at all quadrature points.
+
+        The element tensor of such a block is the product of the argument
+        factors with the sum of the scalar factor over the quadrature
+        points, which pays off for rules with more than one point.
+        """
+        return (
+            quadrature_rule is not None
+            and self.ir.expression.integral_type not in ufl.custom_integral_types
+            and len(quadrature_rule.weights) > 1
+            and len(blockdata.ma_data) > 0
+            and all(mad.tabledata.is_piecewise for mad in blockdata.ma_data)
+        )
+
+    def is_staged(self, tabledata, quadrature_rule) -> bool:
+        """Check if a table is contracted in stages, one direction at a time.
+
+        Tables of cell and facet integrals that are split into 1D factors
+        matching the factors of a tensor product quadrature rule are
+        applied by sum factorisation instead of in the quadrature loop.
+        The factors of facet tables have the normal direction first.
+        """
+        integral_type = self.ir.expression.integral_type
+        if integral_type == "cell":
+            num_normal = 0
+        elif integral_type in ("exterior_facet", "interior_facet"):
+            num_normal = 1
+        else:
+            return False
+        return (
+            quadrature_rule is not None
+            and quadrature_rule.has_tensor_factors
+            and tabledata is not None
+            and tabledata.has_tensor_factorisation
+            and tabledata.ttype == "varying"
+            and len(tabledata.tensor_factors) == len(quadrature_rule.tensor_factors) + num_normal
+        )
+
+    def staged_quadrature_index(self, quadrature_rule):
+        """Quadrature multi-index of the staged contractions.
 
-        return [L.create_nested_for_loops([iq], code)]
+        Facet rules have a single point in the normal direction.
+        """
+        iq = create_quadrature_index(quadrature_rule, self.backend.symbols.quadrature_loop_index)
+        if self.ir.expression.integral_type == "cell":
+            return iq
+        return L.MultiIndex([L.LiteralInt(0)] + iq.symbols, [1] + iq.sizes)
+
+    def staged_table(self, factor, restriction, iq, ic):
+        """Access a factor table in the staged contractions."""
+        table = self.backend.symbols.element_tables[factor.name]
+        if self.ir.expression.integral_type == "cell":
+            return table[0][0][iq][ic]
+        qp = 0
+        if factor.is_permuted:
+            qp = self.backend.symbols.quadrature_permutation[1 if restriction == "-" else 0]
+        return table[qp][self.backend.symbols.entity("facet", restriction)][iq][ic]
+
+    def staged_dof(self, tabledata, restriction, index):
+        """Element dof of a dof of the factors of a table."""
+        if tabledata.facet_tensor_dofs is None:
+            return index
+        qp = 0
+        if tabledata.facet_tensor_dofs.shape[0] > 1:
+            qp = self.backend.symbols.quadrature_permutation[1 if restriction == "-" else 0]
+        entity = self.backend.symbols.entity("facet", restriction)
+        return self.backend.symbols.facet_tensor_dof(tabledata, qp, entity, index)
+
+    def generate_staged_interpolation(self, mt, tabledata, quadrature_rule, domain):
+        """Generate the values of a coefficient at all quadrature points.
+
+        The dofs are contracted with the 1D factor tables one direction
+        at a time, which for degree p in d dimensions costs O(p^(d+1))
+        instead of O(p^(2d)) operations. Stages with the same contracted
+        factors are shared, e.g. between the components of a gradient.
+        On facets the normal direction is contracted first.
+
+        Returns:
+            Access to the value at the current quadrature point.
+        """
+        factors = tabledata.tensor_factors
+        bs = tabledata.block_size
+        begin = tabledata.offset
+        ic = create_dof_index(tabledata, self.backend.symbols.coefficient_dof_sum_index)
+        iq = self.staged_quadrature_index(quadrature_rule)
+
+        order = list(reversed(range(len(factors))))
+        if self.ir.expression.integral_type != "cell":
+            order = order[-1:] + order[:-1]
+
+        source = None
+        contracted: list[int] = []
+        for k in order:
+            # Points in the contracted directions and dofs in the others
+            in_index = _staged_index(ic, iq, contracted)
+            contracted.append(k)
+            out_index = _staged_index(ic, iq, contracted)
+
+            names = tuple(f.name if j in contracted else None for j, f in enumerate(factors))
+            key = ("coefficient", mt.terminal, begin, bs, names)
+            buffer = self.staged_buffers.get(key)
+            if buffer is None:
+                buffer = self.new_temp_symbol("sf")
+                self.staged_buffers[key] = buffer
+                if source is None:
+                    dof = self.staged_dof(tabledata, mt.restriction, in_index.global_index)
+                    value = self.backend.symbols.coefficient_dof_access(mt.terminal, dof, bs, begin)
+                else:
+                    value = source[in_index.global_index]
+                FE = self.staged_table(
+                    factors[k], mt.restriction, iq.local_index(k), ic.local_index(k)
+                )
+                body = [L.AssignAdd(buffer[out_index.global_index], value * FE)]
+                sum_index = L.MultiIndex([ic.local_index(k)], [ic.sizes[k]])
+                self.staged_preparts[(domain, quadrature_rule)] += [
+                    L.ArrayDecl(buffer, int(out_index.size()), [0]),
+                    L.create_nested_for_loops([_loop_index(out_index), sum_index], body),
+                ]
+            source = buffer
+
+        return source[iq.global_index]
+
+    def generate_staged_integration(self, quadrature_rule, domain, blockmap, blockdata, fw):
+        """Generate the integration of a linear form block by sum factorisation.
+
+        Inside the quadrature loop the integrand is only stored at each
+        point. After the loop it is contracted with the 1D factor tables
+        of the test function one direction at a time, on facets the
+        normal direction last. Blocks with the same test function table
+        share the stored integrand.
+
+        Returns:
+            Code for the quadrature loop.
+        """
+        tabledata = blockdata.ma_data[0].tabledata
+        factors = tabledata.tensor_factors
+        offset = tabledata.offset
+        block_size = tabledata.block_size
+        restriction = blockdata.restrictions[0]
+        iq = self.staged_quadrature_index(quadrature_rule)
+
+        factor_names = tuple(f.name for f in factors)
+        key = (
+            "argument",
+            quadrature_rule,
+            restriction,
+            offset,
+            block_size,
+            len(blockmap[0]),
+            factor_names,
+        )
+        buffer = self.staged_buffers.get(key)
+        if buffer is None:
+            buffer = self.new_temp_symbol("sf")
+            self.staged_buffers[key] = buffer
+            self.staged_preparts[(domain, quadrature_rule)] += [
+                L.ArrayDecl(buffer, int(iq.size()), [0])
+            ]
+
+            i = create_dof_index(tabledata, self.backend.symbols.argument_loop_index(0))
+            A_shape = self.ir.expression.tensor_shape
+            postparts = []
+            source = buffer
+            contracted: list[int] = []
+            for k in reversed(range(len(factors))):
+                # Dofs in the contracted directions and points in the others
+                in_index = _staged_index(iq, i, contracted)
+                contracted.append(k)
+                out_index = _staged_index(iq, i, contracted)
+                FE = self.staged_table(factors[k], restriction, iq.local_index(k), i.local_index(k))
+                if k > 0:
+                    target = self.new_temp_symbol("sf")
+                    postparts += [L.ArrayDecl(target, int(out_index.size()), [0])]
+                    lhs = target[out_index.global_index]
+                else:
+                    target = None
+                    dof = self.staged_dof(tabledata, restriction, out_index.global_index)
+                    if len(blockmap[0]) == 1:
+                        A_index = dof + offset
+                    else:
+                        A_index = block_size * dof + offset
+                    lhs = self.backend.symbols.element_tensor_entry(
+                        L.MultiIndex([A_index], A_shape)
+                    )
+                body = [L.AssignAdd(lhs, source[in_index.global_index] * FE)]
+                sum_index = _loop_index(L.MultiIndex([iq.local_index(k)], [iq.sizes[k]]))
+                postparts += [L.create_nested_for_loops([_loop_index(out_index), sum_index], body)]
+                source = target
+            self.staged_postparts[(domain, quadrature_rule)] += postparts
+
+        var = fw if isinstance(fw, L.Symbol) else fw.array
+        body = [L.AssignAdd(buffer[iq.global_index], fw)]
+        return [L.Section("Tensor Computation", body, [], [var], [buffer])]
 
     def generate_piecewise_partition(self, quadrature_rule, domain: basix.CellType):
         """Generate a piecewise partition."""
@@ -332,16 +606,26 @@ class IntegralGenerator:
                 elif mt := attr.get("mt"):
                     tabledata = attr.get("tr")
 
-                    # Backend specific modified terminal translation
-                    vaccess = self.backend.access.get(mt, tabledata, quadrature_rule)
-                    vdef = self.backend.definitions.get(mt, tabledata, quadrature_rule, vaccess)
+                    if isinstance(mt.terminal, ufl.Coefficient) and self.is_staged(
+                        tabledata, quadrature_rule
+                    ):
+                        # Interpolated to all points before the quadrature loop
+                        vaccess = self.generate_staged_interpolation(
+                            mt, tabledata, quadrature_rule, domain
+                        )
+                    else:
+                        # Backend specific modified terminal translation
+                        vaccess = self.backend.access.get(mt, tabledata, quadrature_rule)
+                        vdef = self.backend.definitions.get(
+                            mt, tabledata, quadrature_rule, vaccess
+                        )
 
-                    if vdef:
-                        assert isinstance(vdef, L.Section)
-                    # Only add if definition is unique.
-                    # This can happen when using sub-meshes
-                    if vdef not in definitions:
-                        definitions += [vdef]
+                        if vdef:
+                            assert isinstance(vdef, L.Section)
+                        # Only add if definition is unique.
+                        # This can happen when using sub-meshes
+                        if vdef not in definitions:
+                            definitions += [vdef]
                 else:
                     # Get previously visited operands
                     vops = [self.get_var(quadrature_rule, domain, op) for op in v.ufl_operands]
@@ -351,7 +635,10 @@ class IntegralGenerator:
                     self._ufl_names.add(v._ufl_handler_name_)
                     vexpr = L.ufl_to_lnodes(v, *vops)
 
-                    j = len(intermediates)
+                    # Numbered across calls, as fused kernels generate several
+                    # partitions into the same scope
+                    j = self.symbol_counters[symbol.name]
+                    self.symbol_counters[symbol.name] += 1
                     vaccess = L.Symbol(f"{symbol.name}_{j}", dtype=dtype)
                     intermediates.append(L.VariableDecl(vaccess, vexpr))
 
@@ -449,11 +736,19 @@ class IntegralGenerator:
         # The parts to return
         quadparts: list[L.LNode] = []
         intermediates: list[L.LNode] = []
-        tables = []
-        vars = []
 
-        # RHS expressions grouped by LHS "dofmap"
-        rhs_expressions = collections.defaultdict(list)
+        # RHS expressions by kind of loop nest, grouped by LHS "dofmap",
+        # see generate_tensor_computation
+        rhs_expressions: dict[str, dict] = collections.defaultdict(
+            lambda: collections.defaultdict(list)
+        )
+        input_symbols: list[L.Symbol] = []
+
+        # RHS expressions of blocks applied after the quadrature loop
+        post_rhs_expressions: dict[str, dict] = collections.defaultdict(
+            lambda: collections.defaultdict(list)
+        )
+        post_input: list[L.Symbol] = []
 
         block_rank = len(blockmap)
         iq_symbol = self.backend.symbols.quadrature_loop_index
@@ -467,6 +762,10 @@ class IntegralGenerator:
                 index = create_dof_index(table_ref, symbol)
                 B_indices.append(index)
 
+            if blockdata.transposed:
+                # Computed by mirroring the transposed block
+                continue
+
             ttypes = blockdata.ttypes
             if "zeros" in ttypes:
                 raise RuntimeError(
@@ -513,51 +812,122 @@ class IntegralGenerator:
 
                     intermediates += [L.VariableDecl(fw, fw_rhs)]
 
-            var = fw if isinstance(fw, L.Symbol) else fw.array
-            vars += [var]
-            assert not blockdata.transposed, "Not handled yet"
+            if block_rank == 1 and self.is_staged(blockdata.ma_data[0].tabledata, quadrature_rule):
+                quadparts += self.generate_staged_integration(
+                    quadrature_rule, domain, blockmap, blockdata, fw
+                )
+                continue
 
-            # Fetch code to access modified arguments
-            arg_factors, table = self.get_arg_factors(
-                blockdata, block_rank, quadrature_rule, domain, iq, B_indices
-            )
-            tables += table
+            # Symmetric blocks accumulate their strict upper triangle into
+            # both triangles, and their diagonal separately
+            if blockdata.is_symmetric:
+                parts = [("triangle", B_indices), ("diagonal", [B_indices[1], B_indices[1]])]
+            else:
+                parts = [("full", B_indices)]
 
-            # Define B_rhs = fw * arg_factors
-            B_rhs = L.float_product([fw] + arg_factors)
+            if self.is_quadrature_invariant(blockdata, quadrature_rule):
+                # Sum the scalar factor over the quadrature points, and
+                # apply the argument factors once after the quadrature loop
+                key = (quadrature_rule, factor_index, blockdata.all_factors_piecewise)
+                fq, defined = self.get_temp_symbol("fq", key)
+                if not defined:
+                    self.staged_preparts[(domain, quadrature_rule)] += [L.VariableDecl(fq, 0.0)]
+                    input = [fw if isinstance(fw, L.Symbol) else fw.array]
+                    quadparts += [
+                        L.Section("Quadrature Sum", [L.AssignAdd(fq, fw)], [], input, [fq])
+                    ]
+                scalar_factor = fq
+                expressions = post_rhs_expressions
+                block_input = post_input
+            else:
+                scalar_factor = fw
+                expressions = rhs_expressions
+                block_input = input_symbols
+            block_input += [
+                scalar_factor if isinstance(scalar_factor, L.Symbol) else scalar_factor.array
+            ]
+
+            for kind, indices in parts:
+                A_indices = []
+                for i in range(block_rank):
+                    index = indices[i]
+                    tabledata = blockdata.ma_data[i].tabledata
+                    offset = tabledata.offset
+                    if len(blockmap[i]) == 1:
+                        A_indices.append(index.global_index + offset)
+                    else:
+                        block_size = blockdata.ma_data[i].tabledata.block_size
+                        dof = self.backend.symbols.element_dof(tabledata, index.global_index)
+                        if isinstance(dof, L.ArrayAccess):
+                            block_input.append(dof.array)
+                        A_indices.append(block_size * dof + offset)
+
+                # Fetch code to access modified arguments
+                arg_factors, table = self.get_arg_factors(
+                    blockdata, block_rank, quadrature_rule, domain, iq, indices
+                )
+                block_input += table
+
+                # Define B_rhs = fw * arg_factors
+                B_rhs = L.float_product([scalar_factor] + arg_factors)
+                expressions[kind][tuple(A_indices)].append(B_rhs)
+                if self.ir.expression.symmetric and kind != "diagonal":
+                    # Mirror the transposed block, or the lower triangle
+                    expressions[kind][tuple(A_indices[::-1])].append(B_rhs)
+
+        if post_rhs_expressions:
+            section = self.generate_tensor_computation(
+                post_rhs_expressions, B_indices, post_input
+            )
+            self.staged_postparts[(domain, quadrature_rule)] += optimize(
+                [section], quadrature_rule
+            )
 
-            A_indices = []
-            for i in range(block_rank):
-                index = B_indices[i]
-                tabledata = blockdata.ma_data[i].tabledata
-                offset = tabledata.offset
-                if len(blockmap[i]) == 1:
-                    A_indices.append(index.global_index + offset)
-                else:
-                    block_size = blockdata.ma_data[i].tabledata.block_size
-                    A_indices.append(block_size * index.global_index + offset)
-            rhs_expressions[tuple(A_indices)].append(B_rhs)
+        # All blocks integrated by sum factorisation or after the quadrature loop
+        if not rhs_expressions:
+            return quadparts, intermediates
 
-        # List of statements to keep in the inner loop
-        keep = collections.defaultdict(list)
+        quadparts += [self.generate_tensor_computation(rhs_expressions, B_indices, input_symbols)]
 
-        for indices in rhs_expressions:
-            keep[indices] = rhs_expressions[indices]
+        return quadparts, intermediates
 
-        body: list[L.LNode] = []
+    def generate_tensor_computation(self, rhs_expressions, B_indices, input) -> L.Section:
+        """Generate the loops accumulating expressions into the element tensor.
 
+        Args:
+            rhs_expressions: Expressions to accumulate by the kind of
+                loop nest, grouped by their indices into the element
+                tensor. The loop nest is over all argument indices for
+                "full", over the strict upper triangle for "triangle" and
+                over the diagonal for "diagonal".
+            B_indices: Indices of the argument loops.
+            input: Symbols the expressions depend on.
+        """
         A = self.backend.symbols.element_tensor
         A_shape = self.ir.expression.tensor_shape
-        for indices in keep:
-            multi_index = L.MultiIndex(list(indices), A_shape)
-            for expression in keep[indices]:
-                body.append(L.AssignAdd(A[multi_index], expression))
-
-        # reverse B_indices
-        B_indices = B_indices[::-1]
-        body = [L.create_nested_for_loops(B_indices, body)]
-        input = [*vars, *tables]
+
+        code: list[L.LNode] = []
+        for kind, expressions in rhs_expressions.items():
+            body: list[L.LNode] = []
+            for indices in expressions:
+                entry = self.backend.symbols.element_tensor_entry(
+                    L.MultiIndex(list(indices), A_shape)
+                )
+                for expression in expressions[indices]:
+                    body.append(L.AssignAdd(entry, expression))
+
+            if kind == "triangle":
+                i, j = (index.local_index(0) for index in B_indices)
+                size = B_indices[1].sizes[0]
+                code += [L.ForRange(j, 0, size, [L.ForRange(i, 0, j, body)])]
+            elif kind == "diagonal":
+                code += [L.create_nested_for_loops([B_indices[1]], body)]
+            else:
+                # reverse B_indices
+                code += [L.create_nested_for_loops(B_indices[::-1], body)]
         output = [A]
+        if self.backend.symbols.element_tensor_positions is not None:
+            input = input + [self.backend.symbols.element_tensor_positions]
 
         # Make sure we don't have repeated symbols in input
         input = list(set(input))
@@ -567,9 +937,134 @@ class IntegralGenerator:
         assert all(isinstance(o, L.Symbol) for o in output)
 
         annotations = []
-        if len(B_indices) > 1:
+        if len(B_indices) > 0:
             annotations.append(L.Annotation.licm)
 
-        quadparts += [L.Section("Tensor Computation", body, [], input, output, annotations)]
+        return L.Section("Tensor Computation", code, [], input, output, annotations)
 
-        return quadparts, intermediates
+
+class FusedIntegralGenerator(IntegralGenerator):
+    """Generator of a kernel computing the element tensors of several integrals.
+
+    The integrals are over the same entities of the same mesh, e.g. the
+    integrals of the residual and the Jacobian of a nonlinear problem.
+    The k-th integral writes the element tensor A_k and reads the
+    coefficients w_k and constants c_k. Values of the integrands that
+    are equal across the integrals, such as the geometry and the
+    coefficients at the quadrature points, are computed once, and the
+    quadrature loops over the same rule are fused.
+    """
+
+    def __init__(self, irs, backend, table_pool, element_tensor="A_{k}"):
+        """Initialise.
+
+        Args:
+            irs: Intermediate representations of the integrals.
+            backend: Backend.
+            table_pool: Pool of static tables shared with the other
+                kernels of the module.
+            element_tensor: Name of the element tensor of the k-th
+                integral, formatted with k.
+        """
+        assert table_pool is not None
+        self.irs = irs
+        self.element_tensor = element_tensor
+        super().__init__(irs[0], backend, table_pool)
+
+        # Values of the same coefficient are named alike in all integrals
+        numbering: dict[ufl.Coefficient, int] = {}
+        for ir in irs:
+            for coefficient in ir.expression.coefficient_numbering:
+                numbering.setdefault(coefficient, len(numbering))
+        backend.symbols.coefficient_numbering = numbering
+
+        # State of the generation of each integral. Tables and
+        # temporaries are named per integral, so are not shared.
+        self.element_tables: list[dict] = [{} for _ in irs]
+        self.member_temp_symbols: list[dict] = [{} for _ in irs]
+        self.member_staged_buffers: list[dict] = [{} for _ in irs]
+
+    def init_scopes(self):
+        """Initialize variable scope dicts, shared by all integrals."""
+        self.scopes = {key: {} for ir in self.irs for key in ir.expression.integrand.keys()}
+        self.scopes[(None, None)] = {}
+
+    def integrands(self):
+        """Integrands of all quadrature rules of all integrals."""
+        return [integrand for ir in self.irs for integrand in ir.expression.integrand.values()]
+
+    def select(self, k: int):
+        """Generate the code of the k-th integral from here on."""
+        ir = self.irs[k]
+        self.ir = ir
+        symbols = self.backend.symbols
+        symbols.element_tensor = L.Symbol(
+            self.element_tensor.format(k=k), dtype=L.DataType.SCALAR
+        )
+        symbols.coefficients = L.Symbol(f"w_{k}", dtype=L.DataType.SCALAR)
+        symbols.constants = L.Symbol(f"c_{k}", dtype=L.DataType.SCALAR)
+        symbols.coefficient_offsets = ir.expression.coefficient_offsets
+        symbols.original_constant_offsets = ir.expression.original_constant_offsets
+        symbols.element_tables = self.element_tables[k]
+        self.temp_symbols = self.member_temp_symbols[k]
+        self.staged_buffers = self.member_staged_buffers[k]
+
+    def members(self, domain: basix.CellType, quadrature_rule=None) -> list[int]:
+        """Indices of the integrals over the domain, with the quadrature rule if given."""
+        if quadrature_rule is not None:
+            return [
+                k
+                for k, ir in enumerate(self.irs)
+                if (domain, quadrature_rule) in ir.expression.integrand
+            ]
+        return [
+            k
+            for k, ir in enumerate(self.irs)
+            if any(cell == domain for cell, _ in ir.expression.integrand.keys())
+        ]
+
+    def generate(self, domain: basix.CellType):
+        """Generate the entire body of the fused kernel."""
+        assert not any(d for d in self.scopes.values())
+
+        parts = []
+        for k in self.members(domain):
+            self.select(k)
+            parts += self.generate_quadrature_tables(domain)
+            parts += self.generate_element_tables(domain)
+        parts += self.generate_geometry_tables()
+
+        # Quadrature rules shared by integrals are looped over once
+        rules = dict.fromkeys(
+            rule
+            for k in self.members(domain)
+            for cell, rule in self.irs[k].expression.integrand.keys()
+            if cell == domain
+        )
+        all_preparts = []
+        all_quadparts = []
+        for rule in rules:
+            for k in self.members(domain, rule):
+                self.select(k)
+                all_preparts += self.generate_piecewise_partition(rule, domain)
+            all_quadparts += self.generate_quadrature_loop(rule, domain)
+
+        parts += self.generate_dofmap_tables()
+        parts += all_preparts
+        parts += all_quadparts
+
+        return L.StatementList(optimize_kernel(parts))
+
+    def generate_quadrature_loop_body(
+        self, quadrature_rule: QuadratureRule, domain: basix.CellType
+    ) -> list[L.LNode]:
+        """Generate the sections of the body of the quadrature loop of all integrals.
+
+        The definitions of coefficients and the Jacobian of all integrals
+        are fused by the optimisation of the loop.
+        """
+        code = []
+        for k in self.members(domain, quadrature_rule):
+            self.select(k)
+            code += super().generate_quadrature_loop_body(quadrature_rule, domain)
+        return code
@@ -7,7 +7,7 @@
 
 from __future__ import annotations
 
-import importlib
+import concurrent.futures
 import io
 import logging
 import os
@@ -27,7 +27,9 @@ import ufl
 
 import ffcx
 import ffcx.naming
+import ffcx.profiling
 from ffcx.codegeneration.C.file_template import libraries as _libraries
+from ffcx.codegeneration.cache import ModuleCache, content_hash
 
 logger = logging.getLogger("ffcx")
 root_logger = logging.getLogger()
@@ -71,59 +73,120 @@ UFC_INTEGRAL_DECL += "\n".join(
 )
 
 UFC_INTEGRAL_DECL += "\n".join(
-    re.findall("typedef struct ufcx_integral.*?ufcx_integral;", ufcx_h, re.DOTALL)
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_batch_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_batch_float64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_batch_complex64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_batch_complex128\).*?\);", ufcx_h, re.DOTALL)
 )
 
-UFC_EXPRESSION_DECL = "\n".join(
-    re.findall("typedef struct ufcx_expression.*?ufcx_expression;", ufcx_h, re.DOTALL)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_action_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_action_float64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_action_complex64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_action_complex128\).*?\);", ufcx_h, re.DOTALL)
 )
 
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_geometry_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_geometry_float64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(
+        r"typedef void ?\(ufcx_tabulate_tensor_geometry_complex64\).*?\);", ufcx_h, re.DOTALL
+    )
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(
+        r"typedef void ?\(ufcx_tabulate_tensor_geometry_complex128\).*?\);", ufcx_h, re.DOTALL
+    )
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_geometry_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_geometry_float64\).*?\);", ufcx_h, re.DOTALL)
+)
 
-def _compute_option_signature(options):
-    """Return options signature (some options should not affect signature)."""
-    return str(sorted(options.items()))
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_gather_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_gather_float64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_gather_complex64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_gather_complex128\).*?\);", ufcx_h, re.DOTALL)
+)
 
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_scatter_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_scatter_float64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(
+        r"typedef void ?\(ufcx_tabulate_tensor_scatter_complex64\).*?\);", ufcx_h, re.DOTALL
+    )
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(
+        r"typedef void ?\(ufcx_tabulate_tensor_scatter_complex128\).*?\);", ufcx_h, re.DOTALL
+    )
+)
 
-def get_cached_module(module_name, object_names, cache_dir, timeout):
-    """Look for an existing C file and wait for compilation, or if it does not exist, create it."""
-    cache_dir = Path(cache_dir)
-    c_filename = cache_dir.joinpath(module_name).with_suffix(".c")
-    ready_name = c_filename.with_suffix(".c.cached")
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_fused_float32\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_fused_float64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_fused_complex64\).*?\);", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef void ?\(ufcx_tabulate_tensor_fused_complex128\).*?\);", ufcx_h, re.DOTALL)
+)
 
-    # Ensure cache dir exists
-    cache_dir.mkdir(exist_ok=True, parents=True)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall("typedef struct ufcx_integral_stats.*?ufcx_integral_stats;", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef struct ufcx_integral\b.*?ufcx_integral;", ufcx_h, re.DOTALL)
+)
+UFC_INTEGRAL_DECL += "\n".join(
+    re.findall(r"typedef struct ufcx_fused_integral.*?ufcx_fused_integral;", ufcx_h, re.DOTALL)
+)
 
-    try:
-        # Create C file with exclusive access
-        with open(c_filename, "x"):
-            pass
-        return None, None
-    except FileExistsError:
-        logger.info("Cached C file already exists: " + str(c_filename))
-        finder = importlib.machinery.FileFinder(
-            str(cache_dir),
-            (importlib.machinery.ExtensionFileLoader, importlib.machinery.EXTENSION_SUFFIXES),
-        )
-        finder.invalidate_caches()
+UFC_EXPRESSION_DECL = "\n".join(
+    re.findall("typedef struct ufcx_expression.*?ufcx_expression;", ufcx_h, re.DOTALL)
+)
 
-        # Now, wait for ready
-        for i in range(timeout):
-            if os.path.exists(ready_name):
-                spec = finder.find_spec(module_name)
-                if spec is None:
-                    raise ModuleNotFoundError("Unable to find JIT module.")
-                compiled_module = importlib.util.module_from_spec(spec)
-                spec.loader.exec_module(compiled_module)
+# Modules loaded by this process, keyed by signature name and cache
+# directory. Repeated compilation of the same objects returns the loaded
+# module without touching the file system.
+_loaded_modules: dict[tuple[str, typing.Optional[str]], typing.Any] = {}
 
-                compiled_objects = [getattr(compiled_module.lib, name) for name in object_names]
-                return compiled_objects, compiled_module
 
-            logger.info(f"Waiting for {ready_name} to appear.")
-            time.sleep(1)
-        raise TimeoutError(
-            "JIT compilation timed out, probably due to a failed previous compile. "
-            f"Try cleaning cache (e.g. remove {c_filename}) or increase timeout option."
-        )
+def _compute_option_signature(options):
+    """Return options signature (some options should not affect signature)."""
+    return str(sorted(options.items()))
 
 
 def _compilation_signature(cffi_extra_compile_args, cffi_debug):
@@ -160,6 +223,10 @@ def compile_forms(
     cffi_debug: bool = False,
     cffi_libraries: list[str] = [],
     visualise: bool = False,
+    split_units: bool = False,
+    num_workers: typing.Optional[int] = None,
+    cache_size_limit: typing.Optional[int] = None,
+    constant_values: typing.Optional[dict[ufl.Constant, npt.ArrayLike]] = None,
 ):
     """Compile a list of UFL forms into UFC Python objects.
 
@@ -167,66 +234,103 @@ def compile_forms(
         forms: List of ufl.form to compile.
         options: Options
         cache_dir: Cache directory
-        timeout: Timeout
+        timeout: Maximum time (seconds) to wait for another process
+            compiling the same module
         cffi_extra_compile_args: Extra compilation args for CFFI
         cffi_verbose: Use verbose compile
         cffi_debug: Use compiler debug mode
         cffi_libraries: libraries to use with compiler
         visualise: Toggle visualisation
+        split_units: Generate and compile each form in its own
+            translation unit, cached on the signature of the form, and
+            link the units into the module. Changing one form then only
+            recompiles that form.
+        num_workers: Number of parallel C compiler processes used for the
+            translation units when ``split_units`` is set. Defaults to the
+            number of CPUs.
+        cache_size_limit: Maximum size (bytes) of the cache directory, least
+            recently used modules, and the translation units no cached
+            module links, are evicted beyond it. No limit if None.
+        constant_values: Known values of Constants of the forms, by
+            Constant. The values are folded into the kernels, which are
+            cached separately for each set of values. The kernels still
+            take all Constants of the forms in their argument c.
     """
     p = ffcx.options.get_options(options)
 
     # Get a signature for these forms
-    module_name = "libffcx_forms_" + ffcx.naming.compute_signature(
-        forms,
-        _compute_option_signature(p) + _compilation_signature(cffi_extra_compile_args, cffi_debug),
+    signature_tag = _compute_option_signature(p) + _compilation_signature(
+        cffi_extra_compile_args, cffi_debug
     )
-
-    form_names = [ffcx.naming.form_name(form, i, module_name) for i, form in enumerate(forms)]
-
-    if cache_dir is not None:
-        cache_dir = Path(cache_dir)
-        obj, mod = get_cached_module(module_name, form_names, cache_dir, timeout)
-        if obj is not None:
-            return obj, mod, (None, None)
+    if split_units:
+        module_name = "libffcx_forms_" + ffcx.naming.compute_signature(
+            forms,
+            signature_tag
+            + "split_units"
+            + ffcx.naming.constant_values_signature(forms, constant_values),
+        )
+        unit_names: typing.Optional[list[str]] = [
+            "libffcx_unit_"
+            + ffcx.naming.compute_signature(
+                [form],
+                signature_tag + ffcx.naming.constant_values_signature([form], constant_values),
+            )
+            for form in forms
+        ]
+        form_names = [
+            ffcx.naming.form_name(form, 0, unit_name) for form, unit_name in zip(forms, unit_names)
+        ]
     else:
-        cache_dir = Path(tempfile.mkdtemp())
-
-    try:
-        decl = (
-            UFC_HEADER_DECL.format(np.dtype(p["scalar_type"]).name)  # type: ignore
-            + UFC_INTEGRAL_DECL
-            + UFC_FORM_DECL
+        module_name = "libffcx_forms_" + ffcx.naming.compute_signature(
+            forms, signature_tag + ffcx.naming.constant_values_signature(forms, constant_values)
         )
+        form_names = [ffcx.naming.form_name(form, i, module_name) for i, form in enumerate(forms)]
+        unit_names = None
 
-        form_template = "extern ufcx_form {name};\n"
-        for name in form_names:
-            decl += form_template.format(name=name)
-
-        impl = _compile_objects(
-            decl,
-            forms,
-            form_names,
-            module_name,
-            p,
-            cache_dir,
-            cffi_extra_compile_args,
-            cffi_verbose,
-            cffi_debug,
-            cffi_libraries,
-            visualise=visualise,
-        )
-    except Exception as e:
-        try:
-            # remove c file so that it will not timeout next time
-            c_filename = cache_dir.joinpath(module_name + ".c")
-            os.replace(c_filename, c_filename.with_suffix(".c.failed"))
-        except Exception:
-            pass
-        raise e
+    decl = (
+        UFC_HEADER_DECL.format(np.dtype(p["scalar_type"]).name)  # type: ignore
+        + UFC_INTEGRAL_DECL
+        + UFC_FORM_DECL
+    )
 
-    obj, module = _load_objects(cache_dir, module_name, form_names)
-    return obj, module, (decl, impl)
+    form_template = "extern ufcx_form {name};\n"
+    for name in form_names:
+        decl += form_template.format(name=name)
+
+    def generate(build_dir):
+        if split_units:
+            return _compile_units(
+                forms,
+                unit_names,
+                form_names,
+                p,
+                build_dir,
+                cffi_extra_compile_args,
+                cffi_debug,
+                num_workers,
+                visualise=visualise,
+                constant_values=constant_values,
+            )
+        else:
+            return _compile_objects(
+                forms, module_name, p, visualise=visualise, constant_values=constant_values
+            )
+
+    return _jit(
+        decl,
+        generate,
+        module_name,
+        form_names,
+        p,
+        cache_dir,
+        timeout,
+        cache_size_limit,
+        cffi_extra_compile_args,
+        cffi_verbose,
+        cffi_debug,
+        cffi_libraries,
+        unit_names=unit_names,
+    )
 
 
 def compile_expressions(
@@ -239,6 +343,7 @@ def compile_expressions(
     cffi_debug: bool = False,
     cffi_libraries: list[str] = [],
     visualise: bool = False,
+    cache_size_limit: typing.Optional[int] = None,
 ):
     """Compile a list of UFL expressions into UFC Python objects.
 
@@ -246,12 +351,15 @@ def compile_expressions(
         expressions: List of (UFL expression, evaluation points).
         options: Options
         cache_dir: Cache directory
-        timeout: Timeout
+        timeout: Maximum time (seconds) to wait for another process
+            compiling the same module
         cffi_extra_compile_args: Extra compilation args for CFFI
         cffi_verbose: Use verbose compile
         cffi_debug: Use compiler debug mode
         cffi_libraries: libraries to use with compiler
         visualise: Toggle visualisation
+        cache_size_limit: Maximum size (bytes) of the cache directory, least
+            recently used modules are evicted beyond it. No limit if None.
     """
     p = ffcx.options.get_options(options)
 
@@ -263,75 +371,258 @@ def compile_expressions(
         ffcx.naming.expression_name(expression, module_name) for expression in expressions
     ]
 
-    if cache_dir is not None:
-        cache_dir = Path(cache_dir)
-        obj, mod = get_cached_module(module_name, expr_names, cache_dir, timeout)
-        if obj is not None:
-            return obj, mod, (None, None)
-    else:
-        cache_dir = Path(tempfile.mkdtemp())
+    decl = (
+        UFC_HEADER_DECL.format(np.dtype(p["scalar_type"]).name)  # type: ignore
+        + UFC_INTEGRAL_DECL
+        + UFC_FORM_DECL
+        + UFC_EXPRESSION_DECL
+    )
 
-    try:
-        decl = (
-            UFC_HEADER_DECL.format(np.dtype(p["scalar_type"]).name)  # type: ignore
-            + UFC_INTEGRAL_DECL
-            + UFC_FORM_DECL
-            + UFC_EXPRESSION_DECL
-        )
+    expression_template = "extern ufcx_expression {name};\n"
+    for name in expr_names:
+        decl += expression_template.format(name=name)
 
-        expression_template = "extern ufcx_expression {name};\n"
-        for name in expr_names:
-            decl += expression_template.format(name=name)
-
-        impl = _compile_objects(
-            decl,
-            expressions,
-            expr_names,
-            module_name,
-            p,
-            cache_dir,
-            cffi_extra_compile_args,
-            cffi_verbose,
-            cffi_debug,
-            cffi_libraries,
-            visualise=visualise,
-        )
-    except Exception as e:
-        try:
-            # remove c file so that it will not timeout next time
-            c_filename = cache_dir.joinpath(module_name + ".c")
-            os.replace(c_filename, c_filename.with_suffix(".c.failed"))
-        except Exception:
-            pass
-        raise e
+    def generate(build_dir):
+        return _compile_objects(expressions, module_name, p, visualise=visualise)
 
-    obj, module = _load_objects(cache_dir, module_name, expr_names)
-    return obj, module, (decl, impl)
+    return _jit(
+        decl,
+        generate,
+        module_name,
+        expr_names,
+        p,
+        cache_dir,
+        timeout,
+        cache_size_limit,
+        cffi_extra_compile_args,
+        cffi_verbose,
+        cffi_debug,
+        cffi_libraries,
+    )
 
 
-def _compile_objects(
+def _jit(
     decl,
-    ufl_objects,
-    object_names,
+    generate,
     module_name,
+    object_names,
     options,
     cache_dir,
+    timeout,
+    cache_size_limit,
     cffi_extra_compile_args,
     cffi_verbose,
     cffi_debug,
     cffi_libraries,
-    visualise: bool = False,
+    unit_names=None,
 ):
-    import ffcx.compiler
+    """Load a module from the cache, or generate, build and publish it.
+
+    The module is looked up by ``module_name``, the signature of the UFL
+    objects and options. If it is not cached, the code is generated and
+    the module is named after the hash of the generated source and build
+    inputs, so that a module is never reused for different code.
+    Modules already loaded by this process are returned directly.
+    The translation units ``unit_names`` linked into the module are
+    recorded in the cache, which keeps them while the module is cached.
+    """
+    key = (module_name, None if cache_dir is None else str(Path(cache_dir).resolve()))
+    module = _loaded_modules.get(key)
+    if module is not None:
+        logger.info(f"Reusing JIT module {module_name} loaded by this process")
+        return _load_objects(module, object_names), module, (None, None)
+
+    if cache_dir is None:
+        cache_dir = Path(tempfile.mkdtemp())
+    cache = ModuleCache(Path(cache_dir), timeout, cache_size_limit)
+
+    # Fast path, without taking the lock or generating code
+    module = cache.load(module_name)
+    if module is not None:
+        _loaded_modules[key] = module
+        return _load_objects(module, object_names), module, (None, None)
+
+    with cache.lock(module_name):
+        # Another process may have published the module while we waited
+        module = cache.load(module_name)
+        if module is not None:
+            _loaded_modules[key] = module
+            return _load_objects(module, object_names), module, (None, None)
+
+        if unit_names is not None:
+            cache.write_units(module_name, unit_names)
+        with cache.build_dir() as build_dir:
+            code_body, impl, extra_objects = generate(Path(build_dir))
+            content_name = module_name.rsplit("_", 1)[0] + "_" + content_hash(
+                decl,
+                code_body,
+                impl,
+                _compilation_signature(cffi_extra_compile_args, cffi_debug),
+                str(cffi_libraries),
+            )
+            module = cache.load_content(content_name)
+            if module is None:
+                _build_module(
+                    decl,
+                    code_body,
+                    content_name,
+                    options,
+                    Path(build_dir),
+                    cffi_extra_compile_args,
+                    cffi_verbose,
+                    cffi_debug,
+                    cffi_libraries,
+                    extra_objects=extra_objects,
+                )
+                cache.publish(content_name, Path(build_dir))
+                module = cache.load_content(content_name)
+                if module is None:
+                    raise ModuleNotFoundError("Unable to find JIT module.")
+        cache.write_index(module_name, content_name)
+
+    _loaded_modules[key] = module
+    cache.evict()
+    return _load_objects(module, object_names), module, (decl, impl)
 
-    libraries = _libraries + cffi_libraries if cffi_libraries is not None else _libraries
+
+def _compile_objects(
+    ufl_objects, module_name, options, visualise: bool = False, constant_values=None
+):
+    """Generate the code of a module.
+
+    Returns:
+        The source of the module, the generated implementation and the
+        extra object files to link (none).
+    """
+    import ffcx.compiler
 
     # JIT uses module_name as prefix, which is needed to make names of all struct/function
     # unique across modules
     _, code_body = ffcx.compiler.compile_ufl_objects(
-        ufl_objects, prefix=module_name, options=options, visualise=visualise
+        ufl_objects,
+        prefix=module_name,
+        options=options,
+        visualise=visualise,
+        constant_values=constant_values,
     )
 
+    return code_body, code_body, []
+
+
+def _compile_units(
+    forms,
+    unit_names,
+    form_names,
+    options,
+    build_dir,
+    cffi_extra_compile_args,
+    cffi_debug,
+    num_workers,
+    visualise: bool = False,
+    constant_values=None,
+):
+    """Compile each form in its own translation unit.
+
+    Units are cached next to the build directory on their own signature.
+    Only units without a cached object file are generated and compiled,
+    the C compiler being run in parallel for the units.
+
+    Returns:
+        The source of the module, which only refers to the forms defined
+        in the units, the generated implementation of all units and the
+        unit object files to link.
+    """
+    import ffcx.compiler
+
+    _check_complex_support(options)
+    cache_dir = build_dir.parent
+
+    # Generate code for units which are not cached, skipping duplicates
+    units = dict(zip(unit_names, forms))
+    code_bodies = {}
+    pending = []
+    for unit_name, form in units.items():
+        c_filename = cache_dir.joinpath(unit_name + ".c")
+        obj_filename = _unit_object_filename(cache_dir, unit_name)
+        if obj_filename.exists():
+            logger.info(f"Using cached translation unit {unit_name}")
+            code_bodies[unit_name] = c_filename.read_text()
+            os.utime(obj_filename)
+            continue
+
+        _, code_body = ffcx.compiler.compile_ufl_objects(
+            [form],
+            prefix=unit_name,
+            options=options,
+            visualise=visualise,
+            constant_values=constant_values,
+        )
+        _write_atomic(c_filename, code_body)
+        code_bodies[unit_name] = code_body
+        pending.append(unit_name)
+
+    compile_args = _compile_args(cffi_extra_compile_args)
+    t0 = time.time()
+    max_workers = num_workers if num_workers is not None else os.cpu_count()
+    with ffcx.profiling.timer("jit_compile", stage=True):
+        with concurrent.futures.ThreadPoolExecutor(max_workers=max_workers) as executor:
+            futures = [
+                executor.submit(
+                    _compile_unit,
+                    cache_dir.joinpath(unit_name + ".c"),
+                    _unit_object_filename(cache_dir, unit_name),
+                    compile_args,
+                    cffi_debug,
+                )
+                for unit_name in pending
+            ]
+            for future in futures:
+                future.result()
+    logger.info(f"Compiled {len(pending)} translation units in {time.time() - t0:.4f}")
+
+    main_body = "#include <ufcx.h>\n"
+    main_body += "".join(f"extern ufcx_form {name};\n" for name in form_names)
+    extra_objects = [str(_unit_object_filename(cache_dir, name)) for name in units]
+    return main_body, "\n".join(code_bodies.values()), extra_objects
+
+
+def _unit_object_filename(cache_dir, unit_name):
+    """Object file of a cached translation unit."""
+    suffix = ".obj" if sys.platform.startswith("win32") else ".o"
+    return cache_dir.joinpath(unit_name + suffix)
+
+
+def _write_atomic(filename, text):
+    """Write a file such that other processes never observe partial content."""
+    fd, tmp_name = tempfile.mkstemp(dir=filename.parent, prefix=filename.name, suffix=".tmp")
+    with os.fdopen(fd, "w") as f:
+        f.write(text)
+    os.replace(tmp_name, filename)
+
+
+def _compile_unit(c_filename, obj_filename, compile_args, debug):
+    """Compile a translation unit into an object file, publishing it atomically."""
+    try:
+        import setuptools  # noqa: F401 (provides distutils on Python >= 3.12)
+    except ImportError:
+        pass
+    from distutils.ccompiler import new_compiler
+    from distutils.sysconfig import customize_compiler
+
+    compiler = new_compiler()
+    customize_compiler(compiler)
+    with tempfile.TemporaryDirectory(dir=obj_filename.parent) as tmpdir:
+        (obj,) = compiler.compile(
+            [str(c_filename)],
+            output_dir=tmpdir,
+            include_dirs=[ffcx.codegeneration.get_include_path()],
+            extra_postargs=compile_args,
+            debug=debug,
+        )
+        os.replace(obj, obj_filename)
+
+
+def _check_complex_support(options):
     # Raise error immediately prior to compilation if no support for C99
     # _Complex. Doing this here allows FFCx to be used for complex codegen on
     # Windows.
@@ -341,13 +632,33 @@ def _compile_objects(
         elif isinstance(options["scalar_type"], str) and "complex" in options["scalar_type"]:
             raise NotImplementedError("win32 platform does not support C99 _Complex numbers")
 
+
+def _compile_args(cffi_extra_compile_args):
     # Compile in C17 mode
     if sys.platform.startswith("win32"):
         cffi_base_compile_args = ["-std:c17"]
     else:
         cffi_base_compile_args = ["-std=c17"]
 
-    cffi_final_compile_args = cffi_base_compile_args + cffi_extra_compile_args
+    return cffi_base_compile_args + cffi_extra_compile_args
+
+
+def _build_module(
+    decl,
+    code_body,
+    module_name,
+    options,
+    build_dir,
+    cffi_extra_compile_args,
+    cffi_verbose,
+    cffi_debug,
+    cffi_libraries,
+    extra_objects=[],
+):
+    """Build the CFFI module for the given source and declarations in ``build_dir``."""
+    libraries = _libraries + cffi_libraries if cffi_libraries is not None else _libraries
+
+    _check_complex_support(options)
 
     ffibuilder = cffi.FFI()
 
@@ -355,18 +666,13 @@ def _compile_objects(
         module_name,
         code_body,
         include_dirs=[ffcx.codegeneration.get_include_path()],
-        extra_compile_args=cffi_final_compile_args,
+        extra_compile_args=_compile_args(cffi_extra_compile_args),
         libraries=libraries,
+        extra_objects=extra_objects,
     )
 
     ffibuilder.cdef(decl)
 
-    c_filename = cache_dir.joinpath(module_name + ".c")
-    ready_name = c_filename.with_suffix(".c.cached")
-
-    # Compile (ensuring that compile dir exists)
-    cache_dir.mkdir(exist_ok=True, parents=True)
-
     logger.info(79 * "#")
     logger.info("Calling JIT C compiler")
     logger.info(79 * "#")
@@ -377,49 +683,18 @@ def _compile_objects(
     # since CFFI logs into root logger
     old_handlers = root_logger.handlers.copy()
     root_logger.handlers = [logging.StreamHandler(f)]
-    with redirect_stdout(f):
-        ffibuilder.compile(tmpdir=cache_dir, verbose=True, debug=cffi_debug)
+    with redirect_stdout(f), ffcx.profiling.timer("jit_compile", stage=True):
+        ffibuilder.compile(tmpdir=build_dir, verbose=True, debug=cffi_debug)
     s = f.getvalue()
     if cffi_verbose:
         print(s)
 
     logger.info(f"JIT C compiler finished in {time.time() - t0:.4f}")
 
-    # Create a "status ready" file. If this fails, it is an error,
-    # because it should not exist yet.
-    # Copy the stdout verbose output of the build into the ready file
-    fd = open(ready_name, "x")
-    fd.write(s)
-    fd.close()
-
     # Copy back the original handlers (in case someone is logging into
     # root logger and has custom handlers)
     root_logger.handlers = old_handlers
 
-    return code_body
-
-
-def _load_objects(cache_dir, module_name, object_names):
-    # Create module finder that searches the compile path
-    finder = importlib.machinery.FileFinder(
-        str(cache_dir),
-        (importlib.machinery.ExtensionFileLoader, importlib.machinery.EXTENSION_SUFFIXES),
-    )
-
-    # Find module. Clear search cache to be sure dynamically created
-    # (new) modules are found
-    finder.invalidate_caches()
-    spec = finder.find_spec(module_name)
-    if spec is None:
-        raise ModuleNotFoundError("Unable to find JIT module.")
-
-    # Load module
-    compiled_module = importlib.util.module_from_spec(spec)
-    spec.loader.exec_module(compiled_module)
-
-    compiled_objects = []
-    for name in object_names:
-        obj = getattr(compiled_module.lib, name)
-        compiled_objects.append(obj)
 
-    return compiled_objects, compiled_module
+def _load_objects(module, object_names):
+    return [getattr(module.lib, name) for name in object_names]
@@ -101,7 +101,9 @@ class DataType(Enum):
     """Representation of data types for variables in LNodes.
 
     These can be REAL (same type as geometry),
-    SCALAR (same type as tensor), or INT (for entity indices etc.)
+    SCALAR (same type as tensor), TABLE (same type as the static tables
+    of basis function values and quadrature weights), or INT (for entity
+    indices etc.)
     """
 
     REAL = 0
@@ -109,16 +111,19 @@ class DataType(Enum):
     INT = 2
     BOOL = 3
     NONE = 4
+    TABLE = 5
 
 
 def merge_dtypes(dtypes: list[DataType]):
-    """Promote dtype to SCALAR or REAL if either argument matches."""
+    """Promote dtype to SCALAR, REAL or TABLE if either argument matches."""
     if DataType.NONE in dtypes:
         raise ValueError(f"Invalid DataType in LNodes {dtypes}")
     if DataType.SCALAR in dtypes:
         return DataType.SCALAR
     elif DataType.REAL in dtypes:
         return DataType.REAL
+    elif DataType.TABLE in dtypes:
+        return DataType.TABLE
     elif DataType.INT in dtypes:
         return DataType.INT
     elif DataType.BOOL in dtypes:
@@ -367,12 +372,14 @@ class MultiIndex(LExpr):
         for sym in self.symbols:
             assert sym.dtype == DataType.INT
 
+        # Entries fixed to zero do not contribute to the flat index
         dim = len(sizes)
-        if dim == 0:
+        stride = [np.prod(sizes[i:]) for i in range(dim)] + [LiteralInt(1)]
+        terms = [n * sym for n, sym in zip(stride[1:], self.symbols) if not is_zero_lexpr(sym)]
+        if len(terms) == 0:
             self.global_index: LExpr = LiteralInt(0)
         else:
-            stride = [np.prod(sizes[i:]) for i in range(dim)] + [LiteralInt(1)]
-            self.global_index = Sum(n * sym for n, sym in zip(stride[1:], symbols))
+            self.global_index = Sum(terms)
 
     @property
     def dim(self):
@@ -1027,6 +1034,47 @@ def depth(code) -> int:
     return 0
 
 
+def count_flops(code) -> int:
+    """Estimate the number of floating point operations executed by code.
+
+    Loops are assumed to run over their full range and both branches of
+    conditionals are counted. Integer (index) arithmetic is not counted.
+    """
+    if isinstance(code, (list, tuple)):
+        return sum(count_flops(c) for c in code)
+    if isinstance(code, (StatementList, Section)):
+        return count_flops(code.statements)
+    if isinstance(code, ForRange):
+        if isinstance(code.begin, LiteralInt) and isinstance(code.end, LiteralInt):
+            trip_count = code.end.value - code.begin.value
+        else:
+            trip_count = 1
+        return trip_count * count_flops(code.body)
+    if isinstance(code, Comment) or isinstance(code, ArrayDecl):
+        return 0
+    if isinstance(code, VariableDecl):
+        return count_flops(code.value) if code.value is not None else 0
+    if isinstance(code, Statement):
+        return count_flops(code.expr)
+    if isinstance(code, AssignOp):
+        return count_flops(code.rhs) + (0 if isinstance(code, Assign) else 1)
+    if getattr(code, "dtype", None) == DataType.INT:
+        return 0
+    if isinstance(code, ArithmeticBinOp):
+        return 1 + count_flops(code.lhs) + count_flops(code.rhs)
+    if isinstance(code, BinOp):
+        return count_flops(code.lhs) + count_flops(code.rhs)
+    if isinstance(code, NaryOp):
+        return len(code.args) - 1 + count_flops(code.args)
+    if isinstance(code, MathFunction):
+        return 1 + count_flops(code.args)
+    if isinstance(code, PrefixUnaryOp):
+        return count_flops(code.arg)
+    if isinstance(code, Conditional):
+        return count_flops(code.condition) + count_flops(code.true) + count_flops(code.false)
+    return 0
+
+
 class ForRange(Statement):
     """Slightly higher-level for loop assuming incrementing an index over a range."""
 
@@ -1059,10 +1107,10 @@ def _math_function(op, *args):
     """Get a math function."""
     name = op._ufl_handler_name_
     dtype = args[0].dtype
-    if name in ("conj", "real") and dtype == DataType.REAL:
+    if name in ("conj", "real") and dtype in (DataType.REAL, DataType.TABLE):
         assert len(args) == 1
         return args[0]
-    if name == "imag" and dtype == DataType.REAL:
+    if name == "imag" and dtype in (DataType.REAL, DataType.TABLE):
         assert len(args) == 1
         return LiteralFloat(0.0)
     return MathFunction(name, args)
@@ -1,9 +1,12 @@
 """Optimizer."""
 
-from collections import defaultdict
-from typing import Union
+import itertools
+import math
+from collections import Counter, defaultdict
+from typing import Callable, Iterator, Optional
 
 import ffcx.codegeneration.lnodes as L
+from ffcx import profiling
 from ffcx.ir.representationutils import QuadratureRule
 
 
@@ -17,16 +20,19 @@ def optimize(code: list[L.LNode], quadrature_rule: QuadratureRule) -> list[L.LNo
     Returns:
         Optimized list of LNodes.
     """
-    # Fuse sections with the same name and same annotations
-    code = fuse_sections(code, "Coefficient")
-    code = fuse_sections(code, "Jacobian")
-    for i, section in enumerate(code):
-        if isinstance(section, L.Section):
-            if L.Annotation.fuse in section.annotations:
-                section = fuse_loops(section)
-            if L.Annotation.licm in section.annotations:
-                section = licm(section, quadrature_rule)
-            code[i] = section
+    with profiling.timer("optimize"):
+        # Fuse sections with the same name and same annotations
+        code = fuse_sections(code, "Coefficient")
+        code = fuse_sections(code, "Jacobian")
+        code = fuse_sections(code, "JacobianDeterminant")
+        code = fuse_sections(code, "JacobianInverse")
+        for i, section in enumerate(code):
+            if isinstance(section, L.Section):
+                if L.Annotation.fuse in section.annotations:
+                    section = fuse_loops(section)
+                if L.Annotation.licm in section.annotations:
+                    section = licm(section, quadrature_rule)
+                code[i] = section
 
     return code
 
@@ -99,112 +105,707 @@ def fuse_loops(code: L.Section) -> L.Section:
     return L.Section(code.name, output_code, code.declarations, code.input, code.output)
 
 
-def get_statements(statement: Union[L.Statement, L.StatementList]) -> list[L.LNode]:
-    """Get statements from a statement list.
+# Values hoisted to the same loop of a loop nest are kept in scalar
+# variables up to this number, beyond which they are stored in arrays
+# computed before the loop nest to limit register pressure
+max_fused_invariants = 8
+
+
+def _flatten(statements: list[L.LNode]) -> list[L.LNode]:
+    """Flatten nested statement lists into a list of statements."""
+    output: list[L.LNode] = []
+    for statement in statements:
+        if isinstance(statement, L.StatementList):
+            output += _flatten(statement.statements)
+        else:
+            output.append(statement)
+    return output
+
+
+def licm(section: L.Section, quadrature_rule: QuadratureRule) -> L.Section:
+    """Perform loop invariant code motion.
+
+    Each loop nest of the section is optimized by
+    :func:`hoist_loop_invariants`.
 
     Args:
-        statement: Statement list.
+        section: List of LNodes to optimize.
+        quadrature_rule: TODO.
 
     Returns:
-        List of statements.
+        Optimized list of LNodes.
     """
-    if isinstance(statement, L.StatementList):
-        return [statement.expr for statement in statement.statements]
-    else:
-        return [statement.expr]
+    assert L.Annotation.licm in section.annotations
+
+    counter = itertools.count()
+    statements: list[L.LNode] = []
+    for statement in section.statements:
+        if isinstance(statement, L.ForRange):
+            statements += hoist_loop_invariants(statement, counter)
+        else:
+            statements.append(statement)
+    section.statements = statements
+
+    return section
+
 
+def hoist_loop_invariants(
+    loop: L.ForRange, counter: Optional[Iterator[int]] = None
+) -> list[L.LNode]:
+    """Hoist loop invariant factors out of a perfect loop nest.
 
-def check_dependency(statement: L.Statement, index: L.Symbol) -> bool:
-    """Check if a statement depends on a given index.
+    The loop nest must end in accumulations ``A[...] += f0 * f1 * ...``,
+    as generated for the element tensor of any rank. Each factor is
+    moved to the outermost loop in which it varies. Accumulations into
+    the same entry with the same factors varying in the innermost loop
+    are merged by summing their remaining factors, so that the innermost
+    loop does a single multiply-add per entry. A value accumulated into
+    several entries, as into the mirrored entries of a symmetric tensor,
+    is computed once.
+
+    An invariant product is only hoisted when the loops inside the loop
+    it is moved to run more than once. Products hoisted to the same loop
+    are computed in scalar variables at the top of its body, fusing
+    their computation with the loop nest, unless there are more than
+    ``max_fused_invariants`` of them. They are then stored in arrays
+    computed by a copy of the enclosing loops before the loop nest.
 
     Args:
-        statement: Statement to check.
-        index: Index to check.
+        loop: Outermost loop of the loop nest.
+        counter: Counter for the names of the hoisted variables.
 
     Returns:
-        True if statement depends on index, False otherwise.
+        List of LNodes replacing the loop nest. The loop nest is returned
+        unchanged if it does not have the expected form.
     """
-    if isinstance(statement, L.ArrayAccess):
-        if index in statement.indices:
-            return True
+    counter = counter if counter is not None else itertools.count()
+
+    # Collect the perfect loop nest
+    loops = [loop]
+    body = _flatten(loop.body.statements)
+    while len(body) == 1 and isinstance(body[0], L.ForRange):
+        loops.append(body[0])
+        body = _flatten(body[0].body.statements)
+
+    statements = [s.expr if isinstance(s, L.Statement) else s for s in body]
+    if not all(
+        isinstance(s, L.AssignAdd) and isinstance(s.lhs, L.ArrayAccess) for s in statements
+    ):
+        return [loop]
+    if not all(isinstance(lp.index, L.Symbol) for lp in loops):
+        return [loop]
+
+    # Trip counts of the loops, None if the range is not known, as for
+    # loops over a triangle
+    trip_counts: list[Optional[int]] = []
+    for lp in loops:
+        if isinstance(lp.begin, L.LiteralInt) and isinstance(lp.end, L.LiteralInt):
+            trip_counts.append(int(lp.end.value) - int(lp.begin.value))
+        else:
+            trip_counts.append(None)
+    depth = len(loops)
+    positions = {lp.index.name: k for k, lp in enumerate(loops)}
+
+    def level(expr: L.LExpr) -> int:
+        """Position of the innermost loop an expression varies in, -1 if none."""
+        return max((positions[n] for n in _names(expr) if n in positions), default=-1)
+
+    def iterations(m: int) -> int:
+        """Number of iterations of the loops inside loop m, unknown ranges count as two."""
+        return math.prod(2 if n is None else n for n in trip_counts[m + 1 :])
+
+    def has_arrays(m: int) -> bool:
+        """Check if values hoisted to loop m can be stored in arrays."""
+        return all(
+            n is not None and int(lp.begin.value) == 0
+            for lp, n in zip(loops[: m + 1], trip_counts[: m + 1])
+        )
+
+    # Group the accumulations by entry and factors varying in the innermost loop
+    groups: dict[tuple, tuple[L.LExpr, list[L.LExpr], list[list[L.LExpr]]]] = {}
+    for s in statements:
+        factors = list(s.rhs.args) if isinstance(s.rhs, L.Product) else [s.rhs]
+        variant = [f for f in factors if level(f) == depth - 1]
+        invariant = [f for f in factors if level(f) < depth - 1]
+        key = (_key(s.lhs), tuple(sorted(repr(_key(f)) for f in variant)))
+        groups.setdefault(key, (s.lhs, variant, []))[2].append(invariant)
+
+    # Loops at which the merged invariant factors of each group are hoisted
+    hoisted_levels = []
+    for lhs, variant, invariants in groups.values():
+        m = max((level(f) for factors in invariants for f in factors), default=-1)
+        count = len(invariants) + sum(len(factors) for factors in invariants)
+        if count > 2 and (len(invariants) > 1 or iterations(m) > 1):
+            hoisted_levels.append(m)
+        else:
+            hoisted_levels.append(None)
+    counts = Counter(m for m in hoisted_levels if m is not None)
+    use_arrays = {
+        m for m, n in counts.items() if m >= 0 and n > max_fused_invariants and has_arrays(m)
+    }
+
+    fused: dict[int, list[L.LNode]] = defaultdict(list)
+    arrays: list[L.LNode] = []
+    temps: dict[tuple, L.LExpr] = {}
+
+    def temp(value: L.LExpr, m: int) -> L.LExpr:
+        """Hoist a value to loop m, reusing the variable of an equal value."""
+        key = (m, _key(value))
+        if key in temps:
+            return temps[key]
+        symbol = L.Symbol(f"temp_{next(counter)}", dtype=L.DataType.SCALAR)
+        if m in use_arrays:
+            indices = [lp.index for lp in loops[: m + 1]]
+            access = L.ArrayAccess(symbol, indices)
+            arrays.append(L.ArrayDecl(symbol, trip_counts[: m + 1]))
+            fill: L.LNode = L.Assign(access, value)
+            for lp in reversed(loops[: m + 1]):
+                fill = L.ForRange(lp.index, lp.begin, lp.end, [fill])
+            arrays.append(fill)
+            temps[key] = access
+        else:
+            fused[m].append(L.VariableDecl(symbol, value))
+            temps[key] = symbol
+        return temps[key]
+
+    def hoist_product(factors: list[L.LExpr]) -> L.LExpr:
+        """Hoist the factors of a product to the loops they vary in."""
+        if len(factors) < 2:
+            return L.float_product(factors)
+        m = max(level(f) for f in factors)
+        outer = [f for f in factors if level(f) < m]
+        if len(outer) > 1 and iterations(max(level(f) for f in outer)) > 1:
+            outer = [hoist_product(outer)]
+        return temp(L.float_product(outer + [f for f in factors if level(f) == m]), m)
+
+    body = []
+    for (lhs, variant, invariants), m in zip(groups.values(), hoisted_levels):
+        if m is None:
+            for factors in invariants:
+                body.append(L.AssignAdd(lhs, L.float_product(factors + variant)))
+            continue
+        if m in use_arrays:
+            value = L.Sum([L.float_product(factors) for factors in invariants])
+            value = temp(value.args[0] if len(value.args) == 1 else value, m)
+        elif len(invariants) == 1:
+            value = hoist_product(invariants[0])
         else:
-            for i in statement.indices:
-                if isinstance(i, L.Sum) or isinstance(i, L.Product):
-                    if index in i.args:
-                        return True
-    elif isinstance(statement, L.Symbol):
-        return False
-    elif isinstance(statement, L.LiteralFloat) or isinstance(statement, L.LiteralInt):
-        return False
+            value = temp(L.Sum([hoist_product(factors) for factors in invariants]), m)
+        body.append(L.AssignAdd(lhs, L.float_product([value] + variant)))
+
+    # Compute values accumulated into several entries once
+    repeated = Counter(_key(s.rhs) for s in body)
+    for i, s in enumerate(body):
+        if repeated[_key(s.rhs)] > 1 and L.count_flops(s.rhs) > 0:
+            body[i] = L.AssignAdd(s.lhs, temp(s.rhs, depth - 1))
+
+    # Rebuild the loop nest from the inside out
+    for k in reversed(range(depth)):
+        body = [L.ForRange(loops[k].index, loops[k].begin, loops[k].end, fused[k] + body)]
+    return arrays + fused[-1] + body
+
+
+# Integer powers with at most this exponent are expanded into products
+max_power_expansion = 4
+
+# Math functions evaluated at compile time for literal arguments. Python
+# calls the same C library functions as the generated code.
+_folded_functions: dict[str, Callable[..., float]] = {
+    "sqrt": math.sqrt,
+    "exp": math.exp,
+    "ln": math.log,
+    "cos": math.cos,
+    "sin": math.sin,
+    "tan": math.tan,
+    "cosh": math.cosh,
+    "sinh": math.sinh,
+    "tanh": math.tanh,
+    "acos": math.acos,
+    "asin": math.asin,
+    "atan": math.atan,
+    "power": math.pow,
+}
+
+
+def optimize_kernel(code: list[L.LNode]) -> list[L.LNode]:
+    """Optimize the complete body of a kernel.
+
+    Runs after the passes of :func:`optimize` over all sections and
+    quadrature loops of the kernel, so that values computed outside the
+    quadrature loops are reused inside them.
+
+    Args:
+        code: List of LNodes of the kernel body.
+
+    Returns:
+        Optimized list of LNodes.
+    """
+    with profiling.timer("optimize_kernel"):
+        code = eliminate_common_subexpressions(code)
+        code = reduce_divisions(code)
+    return code
+
+
+def _map_expr(expr: L.LExpr, fn: Callable[[L.LExpr], L.LExpr]) -> L.LExpr:
+    """Rebuild an expression bottom up, applying fn to each rebuilt node.
+
+    Array accesses are not entered, as their indices are integer
+    expressions of loop indices.
+    """
+    if isinstance(expr, (L.LExprTerminal, L.ArrayAccess, L.MultiIndex)):
+        return fn(expr)
+    if isinstance(expr, L.PrefixUnaryOp):
+        node = type(expr)(_map_expr(expr.arg, fn))
+    elif isinstance(expr, L.BinOp):
+        node = type(expr)(_map_expr(expr.lhs, fn), _map_expr(expr.rhs, fn))
+    elif isinstance(expr, L.NaryOp):
+        node = type(expr)([_map_expr(arg, fn) for arg in expr.args])
+    elif isinstance(expr, L.MathFunction):
+        node = L.MathFunction(expr.function, [_map_expr(arg, fn) for arg in expr.args])
+    elif isinstance(expr, L.Conditional):
+        node = L.Conditional(
+            _map_expr(expr.condition, fn), _map_expr(expr.true, fn), _map_expr(expr.false, fn)
+        )
     else:
-        raise NotImplementedError(f"Statement {statement} not supported.")
+        raise NotImplementedError(f"Expression {type(expr).__name__} not supported.")
+    return fn(node)
 
-    return False
 
+def _real_literal(expr: L.LExpr) -> bool:
+    """Check if an expression is a real or integer literal."""
+    return isinstance(expr, (L.LiteralFloat, L.LiteralInt)) and not isinstance(
+        expr.value, complex
+    )
 
-def licm(section: L.Section, quadrature_rule: QuadratureRule) -> L.Section:
-    """Perform loop invariant code motion.
+
+def _literal(value, operands: list[L.LExpr]) -> L.LExpr:
+    """Literal with a folded value, integer if all operands are integer."""
+    if all(isinstance(op, L.LiteralInt) for op in operands):
+        return L.LiteralInt(int(value))
+    return L.LiteralFloat(float(value))
+
+
+def _is_one(expr: L.LExpr) -> bool:
+    """Check if an expression is the literal one."""
+    return _real_literal(expr) and expr.value == 1
+
+
+def _without_ones(args: list[L.LExpr]) -> list[L.LExpr]:
+    """Factors of a product without the literal ones that do not change its type."""
+    others = [arg for arg in args if not _is_one(arg)]
+    if all(arg.dtype == L.DataType.INT for arg in others) and any(
+        isinstance(arg, L.LiteralFloat) for arg in args
+    ):
+        # Keep the promotion of an integer product to floating point
+        return args
+    return others
+
+
+def simplify(expr: L.LExpr) -> L.LExpr:
+    """Fold constants and expand small integer powers of a node.
+
+    Only rewrites that give the same result in IEEE arithmetic are
+    applied: operations on literals only are evaluated, multiplications
+    by one are removed, and powers with a small integer exponent become
+    products. The operands of the node are expected to be simplified.
+    """
+    if isinstance(expr, L.Neg) and _real_literal(expr.arg):
+        return _literal(-expr.arg.value, [expr.arg])
+    if isinstance(expr, (L.Add, L.Sub, L.Mul, L.Div)):
+        lhs, rhs = expr.lhs, expr.rhs
+        if _real_literal(lhs) and _real_literal(rhs):
+            if isinstance(expr, L.Add):
+                return _literal(lhs.value + rhs.value, [lhs, rhs])
+            if isinstance(expr, L.Sub):
+                return _literal(lhs.value - rhs.value, [lhs, rhs])
+            if isinstance(expr, L.Mul):
+                return _literal(lhs.value * rhs.value, [lhs, rhs])
+            if isinstance(lhs, L.LiteralFloat) and rhs.value != 0:
+                return L.LiteralFloat(float(lhs.value / rhs.value))
+        if isinstance(expr, L.Mul):
+            args = _without_ones([lhs, rhs])
+            if len(args) == 1:
+                return args[0]
+        if isinstance(expr, L.Div) and _is_one(rhs) and len(_without_ones([lhs, rhs])) == 1:
+            return lhs
+        return expr
+    if isinstance(expr, (L.Sum, L.Product)):
+        if all(_real_literal(arg) for arg in expr.args):
+            value = expr.args[0].value
+            for arg in expr.args[1:]:
+                value = value + arg.value if isinstance(expr, L.Sum) else value * arg.value
+            return _literal(value, expr.args)
+        if isinstance(expr, L.Product):
+            args = _without_ones(expr.args)
+            if len(args) == 1:
+                return args[0]
+            if len(args) < len(expr.args):
+                return L.Product(args) if args else L.LiteralFloat(1.0)
+        return expr
+    if isinstance(expr, L.MathFunction):
+        if expr.function in _folded_functions and all(_real_literal(arg) for arg in expr.args):
+            try:
+                value = _folded_functions[expr.function](*(arg.value for arg in expr.args))
+            except (ValueError, OverflowError):
+                return expr
+            return L.LiteralFloat(float(value))
+        if expr.function == "power":
+            base, exponent = expr.args
+            n = exponent.value if _real_literal(exponent) else None
+            if (
+                n is not None
+                and n == int(n)
+                and 0 < abs(n) <= max_power_expansion
+                and isinstance(base, (L.Symbol, L.ArrayAccess))
+                and base.dtype != L.DataType.INT
+            ):
+                product = base if abs(n) == 1 else L.Product([base] * abs(int(n)))
+                return product if n > 0 else L.Div(L.LiteralFloat(1.0), product)
+    return expr
+
+
+def _key(expr: L.LExpr) -> tuple:
+    """Hashable key of an expression, equal for expressions with equal values.
+
+    Operands of binary commutative operators are sorted, which does not
+    change the result in IEEE arithmetic. Longer sums and products keep
+    their order of evaluation.
+    """
+    if isinstance(expr, L.LiteralFloat):
+        return ("float", expr.value)
+    if isinstance(expr, L.LiteralInt):
+        return ("int", int(expr.value))
+    if isinstance(expr, L.Symbol):
+        return ("symbol", expr.name)
+    if isinstance(expr, L.ArrayAccess):
+        return ("access", expr.array.name, tuple(_key(i) for i in expr.indices))
+    if isinstance(expr, L.MultiIndex):
+        return _key(expr.global_index)
+    if isinstance(expr, L.PrefixUnaryOp):
+        return (type(expr).__name__, _key(expr.arg))
+    if isinstance(expr, L.BinOp):
+        operands = [_key(expr.lhs), _key(expr.rhs)]
+        if isinstance(expr, (L.Add, L.Mul, L.EQ, L.NE, L.And, L.Or)):
+            operands.sort(key=repr)
+        return (type(expr).__name__, *operands)
+    if isinstance(expr, L.NaryOp):
+        operands = [_key(arg) for arg in expr.args]
+        if len(operands) == 2:
+            operands.sort(key=repr)
+        return (type(expr).__name__, *operands)
+    if isinstance(expr, L.MathFunction):
+        return ("function", expr.function, *(_key(arg) for arg in expr.args))
+    if isinstance(expr, L.Conditional):
+        return ("conditional", _key(expr.condition), _key(expr.true), _key(expr.false))
+    raise NotImplementedError(f"Expression {type(expr).__name__} not supported.")
+
+
+def _names(expr: L.LExpr) -> set[str]:
+    """Names of the symbols and arrays an expression depends on."""
+    if isinstance(expr, L.Symbol):
+        return {expr.name}
+    if isinstance(expr, L.ArrayAccess):
+        return {expr.array.name}.union(*(_names(i) for i in expr.indices))
+    if isinstance(expr, L.MultiIndex):
+        return _names(expr.global_index)
+    if isinstance(expr, L.PrefixUnaryOp):
+        return _names(expr.arg)
+    if isinstance(expr, L.BinOp):
+        return _names(expr.lhs) | _names(expr.rhs)
+    if isinstance(expr, (L.NaryOp, L.MathFunction)):
+        return set().union(*(_names(arg) for arg in expr.args))
+    if isinstance(expr, L.Conditional):
+        return _names(expr.condition) | _names(expr.true) | _names(expr.false)
+    return set()
+
+
+def _target(lhs: L.LExpr) -> str:
+    """Name of the variable or array written by an assignment."""
+    return lhs.array.name if isinstance(lhs, L.ArrayAccess) else lhs.name
+
+
+def _writes(statement: L.LNode, declarations: bool = True) -> set[str]:
+    """Names of the variables and arrays written by a statement.
 
     Args:
-        section: List of LNodes to optimize.
-        quadrature_rule: TODO.
+        statement: Statement, list of statements, loop or section.
+        declarations: Include the variables defined by declarations.
+    """
+    if isinstance(statement, L.AssignOp):
+        return {_target(statement.lhs)}
+    if isinstance(statement, list):
+        return set().union(*(_writes(s, declarations) for s in statement))
+    if isinstance(statement, L.StatementList):
+        return _writes(statement.statements, declarations)
+    if isinstance(statement, L.Section):
+        return _writes(list(statement.declarations) + statement.statements, declarations)
+    if isinstance(statement, L.ForRange):
+        return _writes(statement.body, declarations) | _names(statement.index)
+    if isinstance(statement, L.Declaration):
+        return {statement.symbol.name} if declarations else set()
+    if isinstance(statement, L.Statement) and isinstance(statement.expr, L.AssignOp):
+        return {_target(statement.expr.lhs)}
+    return set()
+
+
+def is_vectorisable_loop(loop: L.ForRange) -> bool:
+    """Check if the iterations of an innermost loop are independent.
+
+    This is the case if every statement of the body is a declaration or
+    an assignment to an array entry depending on the loop index, of an
+    array not read elsewhere in the loop. Assignments to scalars, e.g.
+    accumulations of a sum, are loop-carried dependencies.
+    """
+    index = _names(loop.index)
+    targets = set()
+    reads: set[str] = set()
+    for statement in loop.body.statements:
+        if isinstance(statement, L.VariableDecl):
+            reads |= _names(statement.value)
+            continue
+        if isinstance(statement, L.Comment):
+            continue
+        if isinstance(statement, L.Declaration) or not (
+            isinstance(statement, L.Statement) and isinstance(statement.expr, L.AssignOp)
+        ):
+            return False
+        lhs = statement.expr.lhs
+        if not isinstance(lhs, L.ArrayAccess):
+            return False
+        if not index & set().union(*(_names(i) for i in lhs.indices)):
+            return False
+        if any(isinstance(i, L.ArrayAccess) for i in lhs.indices):
+            # Scattered entries may coincide
+            return False
+        targets.add(lhs.array.name)
+        reads |= _names(statement.expr.rhs)
+        reads |= set().union(*(_names(i) for i in lhs.indices))
+    return len(targets) > 0 and not targets & reads
+
+
+class _Scope:
+    """Values available in a block of code, for common subexpression elimination."""
+
+    def __init__(self, parent=None):
+        """Initialise, inheriting the values of the parent scope."""
+        # Expression key -> (variable holding it, names it depends on)
+        self.available: dict[tuple, tuple[L.Symbol, set[str]]] = (
+            dict(parent.available) if parent else {}
+        )
+        # Name of an eliminated variable -> expression replacing it
+        self.replacements: dict[str, L.LExpr] = dict(parent.replacements) if parent else {}
+
+    def kill(self, names: set[str]):
+        """Forget the values that depend on variables or arrays that are written."""
+        if names:
+            self.available = {k: v for k, v in self.available.items() if not v[1] & names}
+
+    def rewrite(self, expr: L.LExpr) -> L.LExpr:
+        """Replace eliminated variables and simplify an expression."""
+
+        def fn(node):
+            if isinstance(node, L.Symbol) and node.name in self.replacements:
+                return self.replacements[node.name]
+            return simplify(node)
+
+        return _map_expr(expr, fn)
+
+
+def eliminate_common_subexpressions(code: list[L.LNode]) -> list[L.LNode]:
+    """Eliminate common subexpressions and fold constants.
+
+    Variables that are defined once are replaced by an earlier variable
+    in scope with the same value, or by their value if it is a literal
+    or another such variable. The values of variables and arrays that
+    are assigned to are forgotten at each assignment, and values defined
+    inside a quadrature loop or a section are not used outside it.
+
+    Args:
+        code: List of LNodes of the kernel body.
 
     Returns:
-        Optimized list of LNodes.
+        List of LNodes.
     """
-    assert L.Annotation.licm in section.annotations
+    # Variables that are assigned to after their declaration
+    assigned = _writes(code, declarations=False)
+    return _cse_block(code, _Scope(), assigned)
 
-    counter = 0
-
-    # Check depth of loops
-    depth = L.depth(section.statements[0])
-    if depth != 2:
-        return section
-
-    # Get statements in the inner loop
-    outer_loop = section.statements[0]
-    inner_loop = outer_loop.body.statements[0]
-
-    # Collect all expressions in the inner loop by corresponding RHS
-    expressions = defaultdict(list)
-    for body in inner_loop.body.statements:
-        statements = get_statements(body)
-        assert isinstance(statements, list)
-        for statement in statements:
-            assert isinstance(statement, L.AssignAdd)  # Expecting AssignAdd
-            rhs = statement.rhs
-            assert isinstance(rhs, L.Product)  # Expecting Sum
-            lhs = statement.lhs
-            assert isinstance(lhs, L.ArrayAccess)  # Expecting ArrayAccess
-            expressions[lhs].append(rhs)
-
-    pre_loop: list[L.LNode] = []
-    for lhs, rhs in expressions.items():
-        for r in rhs:
-            hoist_candidates = []
-            for arg in r.args:
-                dependency = check_dependency(arg, inner_loop.index)
-                if not dependency:
-                    hoist_candidates.append(arg)
-            if len(hoist_candidates) > 1:
-                # create new temp
-                name = f"temp_{counter}"
-                counter += 1
-                temp = L.Symbol(name, L.DataType.SCALAR)
-                for h in hoist_candidates:
-                    r.args.remove(h)
-                # update expression with new temp
-                r.args.append(L.ArrayAccess(temp, [outer_loop.index]))
-                # create code for hoisted term
-                size = outer_loop.end.value - outer_loop.begin.value
-                pre_loop.append(L.ArrayDecl(temp, size, [0]))
-                body = L.Assign(
-                    L.ArrayAccess(temp, [outer_loop.index]), L.Product(hoist_candidates)
-                )
-                pre_loop.append(
-                    L.ForRange(outer_loop.index, outer_loop.begin, outer_loop.end, [body])
-                )
 
-    section.statements = pre_loop + section.statements
+def _cse_block(code: list[L.LNode], scope: _Scope, assigned: set[str]) -> list[L.LNode]:
+    """Eliminate common subexpressions in a sequence of statements."""
+    output: list[L.LNode] = []
+    for statement in code:
+        output += _cse_statement(statement, scope, assigned)
+    return output
 
-    return section
+
+def _cse_statement(statement: L.LNode, scope: _Scope, assigned: set[str]) -> list[L.LNode]:
+    """Eliminate common subexpressions in a statement."""
+    if isinstance(statement, L.AssignOp):
+        statement = L.Statement(statement)
+    if isinstance(statement, list):
+        return _cse_block(statement, scope, assigned)
+    if isinstance(statement, L.StatementList):
+        return _cse_block(statement.statements, scope, assigned)
+    if isinstance(statement, L.VariableDecl):
+        symbol = statement.symbol
+        scope.kill({symbol.name})
+        scope.replacements.pop(symbol.name, None)
+        if statement.value is None:
+            return [statement]
+        value = scope.rewrite(statement.value)
+        if symbol.name not in assigned:
+            if _real_literal(value) or (
+                isinstance(value, L.Symbol)
+                and value.name not in assigned
+                and value.dtype == symbol.dtype
+            ):
+                if isinstance(value, L.LiteralInt) and symbol.dtype != L.DataType.INT:
+                    # Keep the conversion to floating point, e.g. in 1 / x
+                    value = L.LiteralFloat(float(value.value))
+                scope.replacements[symbol.name] = value
+                return []
+            key = (symbol.dtype, _key(value))
+            if key in scope.available:
+                scope.replacements[symbol.name] = scope.available[key][0]
+                return []
+            scope.available[key] = (symbol, _names(value) | {symbol.name})
+        return [L.VariableDecl(symbol, value)]
+    if isinstance(statement, L.ForRange):
+        # Values depending on the loop are recomputed in each iteration
+        scope.kill(_writes(statement))
+        body = _cse_block(statement.body.statements, _Scope(scope), assigned)
+        return [L.ForRange(statement.index, statement.begin, statement.end, body)]
+    if isinstance(statement, L.Section):
+        declarations = []
+        for declaration in statement.declarations:
+            scope.kill({declaration.symbol.name})
+            if isinstance(declaration, L.VariableDecl) and declaration.value is not None:
+                declaration = L.VariableDecl(declaration.symbol, scope.rewrite(declaration.value))
+            declarations.append(declaration)
+        # Statements of a section are a block of their own
+        inner = _Scope(scope)
+        statements = _cse_block(statement.statements, inner, assigned)
+        scope.kill(_writes(statement.statements))
+        input = [inner.replacements.get(s.name, s) for s in statement.input]
+        input = list(dict.fromkeys(s for s in input if isinstance(s, L.Symbol)))
+        return [
+            L.Section(
+                statement.name,
+                statements,
+                declarations,
+                input,
+                list(statement.output),
+                statement.annotations,
+            )
+        ]
+    if isinstance(statement, L.Statement) and isinstance(statement.expr, L.AssignOp):
+        expr = statement.expr
+        rhs = scope.rewrite(expr.rhs)
+        scope.kill({_target(expr.lhs)})
+        return [L.Statement(type(expr)(expr.lhs, rhs))]
+    scope.kill(_writes(statement))
+    return [statement]
+
+
+def _divisors(code: L.LNode, counts: dict[str, int]):
+    """Count the divisions by each variable in code."""
+
+    def fn(node):
+        if isinstance(node, L.Div) and isinstance(node.rhs, L.Symbol):
+            counts[node.rhs.name] += 1
+        return node
+
+    if isinstance(code, L.AssignOp):
+        code = L.Statement(code)
+    if isinstance(code, list):
+        for statement in code:
+            _divisors(statement, counts)
+    elif isinstance(code, L.StatementList):
+        _divisors(code.statements, counts)
+    elif isinstance(code, L.ForRange):
+        _divisors(code.body, counts)
+    elif isinstance(code, L.Section):
+        _divisors(list(code.declarations) + code.statements, counts)
+    elif isinstance(code, L.VariableDecl) and code.value is not None:
+        _map_expr(code.value, fn)
+    elif isinstance(code, L.Statement) and isinstance(code.expr, L.AssignOp):
+        _map_expr(code.expr.rhs, fn)
+
+
+def reduce_divisions(code: list[L.LNode]) -> list[L.LNode]:
+    """Replace repeated divisions by a variable with multiplications by its reciprocal.
+
+    The reciprocal of a variable that is defined once and divided by
+    more than once, typically the Jacobian determinant, is computed
+    after its definition.
+
+    Args:
+        code: List of LNodes of the kernel body.
+
+    Returns:
+        List of LNodes.
+    """
+    counts: dict[str, int] = defaultdict(int)
+    _divisors(code, counts)
+    assigned = _writes(code, declarations=False)
+    divisors = {name for name, count in counts.items() if count > 1 and name not in assigned}
+    if not divisors:
+        return code
+    return _reduce_divisions_block(code, {}, divisors)
+
+
+def _reduce_divisions_block(
+    code: list[L.LNode], reciprocals: dict[str, L.Symbol], divisors: set[str]
+) -> list[L.LNode]:
+    """Replace divisions by variables with known reciprocals in a sequence of statements."""
+
+    def fn(node):
+        if isinstance(node, L.Div) and isinstance(node.rhs, L.Symbol):
+            if node.rhs.name in reciprocals:
+                return simplify(L.Mul(node.lhs, reciprocals[node.rhs.name]))
+        return node
+
+    output: list[L.LNode] = []
+    for statement in code:
+        if isinstance(statement, L.AssignOp):
+            statement = L.Statement(statement)
+        if isinstance(statement, (list, L.StatementList)):
+            statements = statement if isinstance(statement, list) else statement.statements
+            output += _reduce_divisions_block(statements, reciprocals, divisors)
+        elif isinstance(statement, L.VariableDecl) and statement.value is not None:
+            symbol = statement.symbol
+            output.append(L.VariableDecl(symbol, _map_expr(statement.value, fn)))
+            if symbol.name in divisors and symbol.dtype != L.DataType.INT:
+                inverse = L.Symbol(f"{symbol.name}_inv", dtype=symbol.dtype)
+                output.append(L.VariableDecl(inverse, L.Div(L.LiteralFloat(1.0), symbol)))
+                reciprocals[symbol.name] = inverse
+        elif isinstance(statement, L.ForRange):
+            body = _reduce_divisions_block(
+                statement.body.statements, dict(reciprocals), divisors
+            )
+            output.append(L.ForRange(statement.index, statement.begin, statement.end, body))
+        elif isinstance(statement, L.Section):
+            declarations = [
+                L.VariableDecl(d.symbol, _map_expr(d.value, fn))
+                if isinstance(d, L.VariableDecl) and d.value is not None
+                else d
+                for d in statement.declarations
+            ]
+            statements = _reduce_divisions_block(statement.statements, dict(reciprocals), divisors)
+            output.append(
+                L.Section(
+                    statement.name,
+                    statements,
+                    declarations,
+                    statement.input,
+                    list(statement.output),
+                    statement.annotations,
+                )
+            )
+        elif isinstance(statement, L.Statement) and isinstance(statement.expr, L.AssignOp):
+            expr = statement.expr
+            output.append(L.Statement(type(expr)(expr.lhs, _map_expr(expr.rhs, fn))))
+        else:
+            output.append(statement)
+    return output
@@ -76,6 +76,9 @@ class FFCXBackendSymbols:
         self.quadrature_weight_tables = {}
         self.element_tables = {}
 
+        # Tables of the dofs of the columns of compressed element tables
+        self.element_dofmaps = {}
+
         # Reusing a single symbol for all quadrature loops, assumed not to be nested.
         self.quadrature_loop_index = L.Symbol("iq", dtype=L.DataType.INT)
 
@@ -90,6 +93,26 @@ class FFCXBackendSymbols:
         # Index for loops over coefficient dofs, assumed to never be used in two nested loops.
         self.coefficient_dof_sum_index = L.Symbol("ic", dtype=L.DataType.INT)
 
+        # Coefficient replacing the trial function in action kernels, and
+        # the tabulate_action argument holding its dofs
+        self.action_coefficient = None
+        self.action_input = L.Symbol("x", dtype=L.DataType.SCALAR)
+
+        # The tabulate_tensor_geometry argument holding J, detJ and K of
+        # the cell, or None if they are computed from the coordinate dofs
+        self.precomputed_geometry = None
+
+        # The tabulate_tensor_gather argument holding the dofmaps of the
+        # coefficients on the entity, or None if the coefficients are
+        # packed in w
+        self.coefficient_dofmaps = None
+
+        # The tabulate_tensor_scatter argument holding the positions of
+        # the entries of the element tensor in the global values array
+        # (the element tensor symbol), or None if the element tensor is
+        # stored densely
+        self.element_tensor_positions = None
+
         # Table for chunk of custom quadrature weights (including cell measure scaling).
         self.custom_weights_table = L.Symbol("weights_chunk", dtype=L.DataType.REAL)
 
@@ -122,7 +145,7 @@ class FFCXBackendSymbols:
         key = f"weights_{quadrature_rule.id()}"
         if key not in self.quadrature_weight_tables:
             self.quadrature_weight_tables[key] = L.Symbol(
-                f"weights_{quadrature_rule.id()}", dtype=L.DataType.REAL
+                f"weights_{quadrature_rule.id()}", dtype=L.DataType.TABLE
             )
         return self.quadrature_weight_tables[key]
 
@@ -130,6 +153,36 @@ class FFCXBackendSymbols:
         """Table of quadrature points (points on the reference integration entity)."""
         return L.Symbol(f"points_{quadrature_rule.id()}", dtype=L.DataType.REAL)
 
+    def element_dof(self, tabledata, index):
+        """Element dof of a column of an element table.
+
+        Compressed tables whose remaining dofs are not equally spaced
+        look the dof up in a static table, otherwise the column is the
+        dof up to the offset and block size of the table.
+        """
+        if tabledata.dofmap is None:
+            return index
+        if tabledata.dofmap not in self.element_dofmaps:
+            self.element_dofmaps[tabledata.dofmap] = L.Symbol(
+                f"DM{len(self.element_dofmaps)}", dtype=L.DataType.INT
+            )
+        return self.element_dofmaps[tabledata.dofmap][index]
+
+    def facet_tensor_dof(self, tabledata, permutation, facet, index):
+        """Element dof of a dof of the facet-local factors of a facet table.
+
+        The dofs for all quadrature permutations and facets are looked
+        up in one static table.
+        """
+        dofs = tabledata.facet_tensor_dofs
+        dofmap = tuple(int(i) for i in dofs.flat)
+        if dofmap not in self.element_dofmaps:
+            self.element_dofmaps[dofmap] = L.Symbol(
+                f"DM{len(self.element_dofmaps)}", dtype=L.DataType.INT
+            )
+        num_facets, num_dofs = dofs.shape[1:]
+        return self.element_dofmaps[dofmap][(permutation * num_facets + facet) * num_dofs + index]
+
     def x_component(self, mt):
         """Physical coordinate component."""
         return L.Symbol(format_mt_name("x", mt), dtype=L.DataType.REAL)
@@ -140,6 +193,18 @@ class FFCXBackendSymbols:
             format_mt_name(f"J{mt.expr.ufl_domain().ufl_id()}", mt), dtype=L.DataType.REAL
         )
 
+    def detJ(self, mt):
+        """Jacobian determinant."""
+        return L.Symbol(
+            format_mt_name(f"detJ{mt.expr.ufl_domain().ufl_id()}", mt), dtype=L.DataType.REAL
+        )
+
+    def K_component(self, mt):
+        """Jacobian inverse component."""
+        return L.Symbol(
+            format_mt_name(f"K{mt.expr.ufl_domain().ufl_id()}", mt), dtype=L.DataType.REAL
+        )
+
     def domain_dof_access(self, dof, component, gdim, num_scalar_dofs, restriction):
         """Domain DOF access."""
         # FIXME: Add domain number or offset!
@@ -148,19 +213,54 @@ class FFCXBackendSymbols:
             offset = num_scalar_dofs * 3
         return self.coordinate_dofs[3 * dof + component + offset]
 
-    def coefficient_dof_access(self, coefficient, dof_index):
-        """Coefficient DOF access."""
+    def coefficient_dof_access(self, coefficient, dof, block_size, begin):
+        """Coefficient DOF access.
+
+        The packed dof is dof * block_size + begin, where begin includes
+        the offset of the restriction. With gathered coefficients, the dof
+        is read from the global array of the coefficient through its
+        dofmap instead.
+        """
+        dof_index = dof * block_size + begin
+        if self.action_coefficient is not None and coefficient == self.action_coefficient:
+            return self.action_input[dof_index]
+        if self.coefficient_dofmaps is not None:
+            return self.coefficient_dof_gather(coefficient, dof, block_size, begin)
         offset = self.coefficient_offsets[coefficient]
         w = self.coefficients
         return w[offset + dof_index]
 
+    def element_tensor_entry(self, index):
+        """Entry of the element tensor at a flat index, in the global values when scattering."""
+        if self.element_tensor_positions is None:
+            return self.element_tensor[index]
+        return self.element_tensor[self.element_tensor_positions[index]]
+
+    def coefficient_dof_gather(self, coefficient, dof, block_size, begin):
+        """Coefficient DOF access in the global array of the coefficient.
+
+        The packed dof is split into the restriction, the node of the
+        element and the component in the block at compile time, which the
+        strides of element tables being multiples of the block size of
+        the element allow.
+        """
+        element = coefficient.ufl_function_space().ufl_element()
+        bs = element.block_size
+        assert block_size % bs == 0
+        restriction, local = divmod(begin, element.dim)
+        node = dof * (block_size // bs) + local // bs + restriction * (element.dim // bs)
+        n = self.coefficient_numbering[coefficient]
+        return self.coefficients[n][self.coefficient_dofmaps[n][node] * bs + local % bs]
+
     def coefficient_dof_access_blocked(
         self, coefficient: ufl.Coefficient, index, block_size, dof_offset
     ):
         """Blocked coefficient DOF access."""
         coeff_offset = self.coefficient_offsets[coefficient]
         w = self.coefficients
-        _w = L.Symbol(f"_w_{coeff_offset}_{dof_offset}", dtype=L.DataType.SCALAR)
+        if self.action_coefficient is not None and coefficient == self.action_coefficient:
+            w = self.action_input
+        _w = L.Symbol(f"_{w.name}_{coeff_offset}_{dof_offset}", dtype=L.DataType.SCALAR)
         unit_stride_access = _w[index]
         original_access = w[coeff_offset + index * block_size + dof_offset]
         return unit_stride_access, original_access
@@ -200,5 +300,7 @@ class FFCXBackendSymbols:
 
         # Return direct access to element table, reusing symbol if possible
         if tabledata.name not in self.element_tables:
-            self.element_tables[tabledata.name] = L.Symbol(tabledata.name, dtype=L.DataType.REAL)
+            self.element_tables[tabledata.name] = L.Symbol(
+                tabledata.name, dtype=L.DataType.TABLE
+            )
         return self.element_tables[tabledata.name][qp][entity][iq]
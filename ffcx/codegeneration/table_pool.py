@@ -0,0 +1,48 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx. (https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Pool of static tables shared by the kernels of a module."""
+
+import numpy as np
+import numpy.typing as npt
+
+import ffcx.codegeneration.lnodes as L
+from ffcx.ir.elementtables import equal_tables
+
+
+class TablePool:
+    """Static tables shared by the kernels of a module.
+
+    Each distinct table of basis function values or quadrature weights
+    is declared once at file scope, and all kernels using it refer to
+    the same array. Tables are considered equal with the same tolerances
+    as used to reuse tables within an integral.
+    """
+
+    def __init__(self, rtol: float, atol: float):
+        """Initialise.
+
+        Args:
+            rtol: Relative tolerance for comparing table values.
+            atol: Absolute tolerance for comparing table values.
+        """
+        self.rtol = rtol
+        self.atol = atol
+        self.declarations: list[L.ArrayDecl] = []
+        self._by_shape: dict[tuple[int, ...], list[L.ArrayDecl]] = {}
+
+    def get(self, values: npt.NDArray[np.float64]) -> L.Symbol:
+        """Get the symbol of the pooled table with the given values, adding it if new."""
+        values = np.asarray(values)
+        candidates = self._by_shape.setdefault(values.shape, [])
+        for decl in candidates:
+            if equal_tables(decl.values, values, rtol=self.rtol, atol=self.atol):
+                return decl.symbol
+
+        symbol = L.Symbol(f"ffcx_table_{len(self.declarations)}", dtype=L.DataType.TABLE)
+        decl = L.ArrayDecl(symbol, values=values, const=True)
+        candidates.append(decl)
+        self.declarations.append(decl)
+        return symbol
@@ -129,6 +129,380 @@ extern "C"
       const uint8_t* restrict quadrature_permutation, void* custom_data);
 #endif // __STDC_NO_COMPLEX__
 
+  /// Tabulate integral into tensor A for a batch of cells (entities)
+  /// with compiled quadrature rule and single precision
+  ///
+  /// The arguments are those of ufcx_tabulate_tensor_float32, laid out
+  /// contiguously for each entity in the batch, i.e. the data for
+  /// entity i starts at A + i * size(A), w + i * size(w),
+  /// coordinate_dofs + i * size(coordinate_dofs), entity_local_index +
+  /// i * size(entity_local_index) and quadrature_permutation + i *
+  /// size(quadrature_permutation), where size() is the size of the
+  /// corresponding argument of the single entity kernel. The constants
+  /// c and custom_data are shared by all entities in the batch.
+  ///
+  /// @param[in] num_cells Number of entities in the batch.
+  /// @see ufcx_tabulate_tensor_float32
+  typedef void(ufcx_tabulate_tensor_batch_float32)(
+      float* restrict A, const float* restrict w, const float* restrict c,
+      const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, int num_cells,
+      void* custom_data);
+
+  /// Tabulate integral into tensor A for a batch of cells (entities)
+  /// with compiled quadrature rule and double precision
+  ///
+  /// @see ufcx_tabulate_tensor_batch_float32
+  typedef void(ufcx_tabulate_tensor_batch_float64)(
+      double* restrict A, const double* restrict w, const double* restrict c,
+      const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, int num_cells,
+      void* custom_data);
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral into tensor A for a batch of cells (entities)
+  /// with compiled quadrature rule and complex single precision
+  ///
+  /// @see ufcx_tabulate_tensor_batch_float32
+  typedef void(ufcx_tabulate_tensor_batch_complex64)(
+      float _Complex* restrict A, const float _Complex* restrict w,
+      const float _Complex* restrict c, const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, int num_cells,
+      void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral into tensor A for a batch of cells (entities)
+  /// with compiled quadrature rule and complex double precision
+  ///
+  /// @see ufcx_tabulate_tensor_batch_float32
+  typedef void(ufcx_tabulate_tensor_batch_complex128)(
+      double _Complex* restrict A, const double _Complex* restrict w,
+      const double _Complex* restrict c, const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, int num_cells,
+      void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+  /// Apply the element tensor of a bilinear form integral to a vector,
+  /// y += A x, without tabulating A, with compiled quadrature rule and
+  /// single precision
+  ///
+  /// @param[in,out] y Dimensions: y[restriction][test dof], with the
+  /// restriction dimension applying to interior facet integrals.
+  /// @param[in] x Dofs of the trial function. Dimensions:
+  /// x[restriction][trial dof].
+  /// @see ufcx_tabulate_tensor_float32 for the other arguments
+  typedef void(ufcx_tabulate_action_float32)(
+      float* restrict y, const float* restrict x, const float* restrict w,
+      const float* restrict c, const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+  /// Apply the element tensor of a bilinear form integral to a vector
+  /// with compiled quadrature rule and double precision
+  ///
+  /// @see ufcx_tabulate_action_float32
+  typedef void(ufcx_tabulate_action_float64)(
+      double* restrict y, const double* restrict x, const double* restrict w,
+      const double* restrict c, const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Apply the element tensor of a bilinear form integral to a vector
+  /// with compiled quadrature rule and complex single precision
+  ///
+  /// @see ufcx_tabulate_action_float32
+  typedef void(ufcx_tabulate_action_complex64)(
+      float _Complex* restrict y, const float _Complex* restrict x,
+      const float _Complex* restrict w, const float _Complex* restrict c,
+      const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Apply the element tensor of a bilinear form integral to a vector
+  /// with compiled quadrature rule and complex double precision
+  ///
+  /// @see ufcx_tabulate_action_float32
+  typedef void(ufcx_tabulate_action_complex128)(
+      double _Complex* restrict y, const double _Complex* restrict x,
+      const double _Complex* restrict w, const double _Complex* restrict c,
+      const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+  /// Tabulate integral into tensor A with compiled quadrature rule
+  /// and single precision, reading the Jacobian of the cell, its
+  /// determinant and inverse from precomputed geometry instead of
+  /// computing them from the coordinate dofs
+  ///
+  /// @param[in] geometry Geometry of the cell as computed by
+  /// ufcx_form.tabulate_geometry_float32. Dimensions:
+  /// geometry[restriction][ufcx_form.geometry_size], with the
+  /// restriction dimension applying to interior facet integrals.
+  /// @see ufcx_tabulate_tensor_float32 for the other arguments
+  typedef void(ufcx_tabulate_tensor_geometry_float32)(
+      float* restrict A, const float* restrict w, const float* restrict c,
+      const float* restrict coordinate_dofs, const float* restrict geometry,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+  /// Tabulate integral into tensor A with compiled quadrature rule
+  /// and double precision, reading the Jacobian, its determinant and
+  /// inverse from precomputed geometry
+  ///
+  /// @see ufcx_tabulate_tensor_geometry_float32
+  typedef void(ufcx_tabulate_tensor_geometry_float64)(
+      double* restrict A, const double* restrict w, const double* restrict c,
+      const double* restrict coordinate_dofs, const double* restrict geometry,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral into tensor A with compiled quadrature rule
+  /// and complex single precision, reading the Jacobian, its
+  /// determinant and inverse from precomputed geometry
+  ///
+  /// @see ufcx_tabulate_tensor_geometry_float32
+  typedef void(ufcx_tabulate_tensor_geometry_complex64)(
+      float _Complex* restrict A, const float _Complex* restrict w,
+      const float _Complex* restrict c, const float* restrict coordinate_dofs,
+      const float* restrict geometry, const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral into tensor A with compiled quadrature rule
+  /// and complex double precision, reading the Jacobian, its
+  /// determinant and inverse from precomputed geometry
+  ///
+  /// @see ufcx_tabulate_tensor_geometry_float32
+  typedef void(ufcx_tabulate_tensor_geometry_complex128)(
+      double _Complex* restrict A, const double _Complex* restrict w,
+      const double _Complex* restrict c, const double* restrict coordinate_dofs,
+      const double* restrict geometry, const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+  /// Compute the geometry of a cell read by the
+  /// tabulate_tensor_geometry kernels, in single precision
+  ///
+  /// @param[out] geometry The Jacobian J[gdim][tdim] of the affine map
+  /// of the cell, followed by its determinant detJ and its inverse
+  /// K[tdim][gdim], all row-major. For manifolds, with gdim > tdim,
+  /// detJ is the pseudo-determinant sqrt(det(J^T J)) and K the
+  /// pseudo-inverse. Dimensions: geometry[2 * gdim * tdim + 1].
+  /// @param[in] coordinate_dofs Coordinates of the cell nodes.
+  /// Dimensions: coordinate_dofs[num_nodes][3].
+  typedef void(ufcx_tabulate_geometry_float32)(
+      float* restrict geometry, const float* restrict coordinate_dofs);
+
+  /// Compute the geometry of a cell read by the
+  /// tabulate_tensor_geometry kernels, in double precision
+  ///
+  /// @see ufcx_tabulate_geometry_float32
+  typedef void(ufcx_tabulate_geometry_float64)(
+      double* restrict geometry, const double* restrict coordinate_dofs);
+
+  /// Tabulate integral into tensor A with compiled quadrature rule and
+  /// single precision, reading the coefficients from their global dof
+  /// arrays instead of from packed coefficients
+  ///
+  /// @param[in] w Global dof arrays of the coefficients, w[coefficient].
+  /// Entries of coefficients not used by the integral, see
+  /// ufcx_integral.enabled_coefficients, may be null.
+  /// @param[in] dofmaps Dofmaps of the coefficients on the cells of the
+  /// entity. Dimensions: dofmaps[coefficient][restriction][node], with
+  /// the restriction dimension applying to interior facet integrals.
+  /// Component k of node i of a coefficient with element block size bs
+  /// is w[coefficient][bs * dofmaps[coefficient][i] + k].
+  /// @see ufcx_tabulate_tensor_float32 for the other arguments
+  typedef void(ufcx_tabulate_tensor_gather_float32)(
+      float* restrict A, const float* const* restrict w,
+      const int32_t* const* restrict dofmaps, const float* restrict c,
+      const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+  /// Tabulate integral into tensor A with compiled quadrature rule and
+  /// double precision, reading the coefficients from their global dof
+  /// arrays
+  ///
+  /// @see ufcx_tabulate_tensor_gather_float32
+  typedef void(ufcx_tabulate_tensor_gather_float64)(
+      double* restrict A, const double* const* restrict w,
+      const int32_t* const* restrict dofmaps, const double* restrict c,
+      const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral into tensor A with compiled quadrature rule and
+  /// complex single precision, reading the coefficients from their
+  /// global dof arrays
+  ///
+  /// @see ufcx_tabulate_tensor_gather_float32
+  typedef void(ufcx_tabulate_tensor_gather_complex64)(
+      float _Complex* restrict A, const float _Complex* const* restrict w,
+      const int32_t* const* restrict dofmaps,
+      const float _Complex* restrict c, const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral into tensor A with compiled quadrature rule and
+  /// complex double precision, reading the coefficients from their
+  /// global dof arrays
+  ///
+  /// @see ufcx_tabulate_tensor_gather_float32
+  typedef void(ufcx_tabulate_tensor_gather_complex128)(
+      double _Complex* restrict A, const double _Complex* const* restrict w,
+      const int32_t* const* restrict dofmaps,
+      const double _Complex* restrict c,
+      const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+  /// Tabulate integral with compiled quadrature rule and single
+  /// precision, adding the entries of the element tensor directly into
+  /// global storage instead of writing the tensor A
+  ///
+  /// Entry i of the element tensor (in the layout of A) is added to
+  /// values[positions[i]], e.g. with positions the indices into the
+  /// values of a CSR matrix of the rows and columns of the cell dofs,
+  /// or the dofs of the cell for a vector. The additions are atomic if
+  /// the code is compiled with OpenMP and FFCX_NO_ATOMIC is not
+  /// defined, otherwise entities sharing positions must not be
+  /// tabulated concurrently, e.g. by colouring the cells.
+  ///
+  /// @param[in,out] values Global values.
+  /// @param[in] positions Positions in values of the entries of the
+  /// element tensor. Dimensions: positions[tensor size].
+  /// @see ufcx_tabulate_tensor_float32 for the other arguments
+  typedef void(ufcx_tabulate_tensor_scatter_float32)(
+      float* restrict values, const int64_t* restrict positions,
+      const float* restrict w, const float* restrict c,
+      const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+  /// Tabulate integral with compiled quadrature rule and double
+  /// precision, adding the entries of the element tensor directly into
+  /// global storage
+  ///
+  /// @see ufcx_tabulate_tensor_scatter_float32
+  typedef void(ufcx_tabulate_tensor_scatter_float64)(
+      double* restrict values, const int64_t* restrict positions,
+      const double* restrict w, const double* restrict c,
+      const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral with compiled quadrature rule and complex single
+  /// precision, adding the entries of the element tensor directly into
+  /// global storage. The additions are never atomic.
+  ///
+  /// @see ufcx_tabulate_tensor_scatter_float32
+  typedef void(ufcx_tabulate_tensor_scatter_complex64)(
+      float _Complex* restrict values, const int64_t* restrict positions,
+      const float _Complex* restrict w, const float _Complex* restrict c,
+      const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate integral with compiled quadrature rule and complex double
+  /// precision, adding the entries of the element tensor directly into
+  /// global storage. The additions are never atomic.
+  ///
+  /// @see ufcx_tabulate_tensor_scatter_float32
+  typedef void(ufcx_tabulate_tensor_scatter_complex128)(
+      double _Complex* restrict values, const int64_t* restrict positions,
+      const double _Complex* restrict w, const double _Complex* restrict c,
+      const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+  /// Tabulate the element tensors of several integrals over the same
+  /// entity in one pass, with single precision. Values shared by the
+  /// integrals, e.g. the geometry and the coefficients at quadrature
+  /// points, are computed once.
+  ///
+  /// @param[out] A Element tensor of each integral of the fused
+  /// integral, see ufcx_fused_integral.integrals.
+  /// @param[in] w Coefficients of each integral, packed as for its
+  /// tabulate_tensor kernel.
+  /// @param[in] c Constants of each integral, packed as for its
+  /// tabulate_tensor kernel.
+  /// @see ufcx_tabulate_tensor_float32 for the other arguments
+  typedef void(ufcx_tabulate_tensor_fused_float32)(
+      float* const* restrict A, const float* const* restrict w,
+      const float* const* restrict c, const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+  /// Tabulate the element tensors of several integrals over the same
+  /// entity in one pass, with double precision
+  ///
+  /// @see ufcx_tabulate_tensor_fused_float32
+  typedef void(ufcx_tabulate_tensor_fused_float64)(
+      double* const* restrict A, const double* const* restrict w,
+      const double* const* restrict c, const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate the element tensors of several integrals over the same
+  /// entity in one pass, with complex single precision
+  ///
+  /// @see ufcx_tabulate_tensor_fused_float32
+  typedef void(ufcx_tabulate_tensor_fused_complex64)(
+      float _Complex* const* restrict A, const float _Complex* const* restrict w,
+      const float _Complex* const* restrict c, const float* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+#ifndef __STDC_NO_COMPLEX__
+  /// Tabulate the element tensors of several integrals over the same
+  /// entity in one pass, with complex double precision
+  ///
+  /// @see ufcx_tabulate_tensor_fused_float32
+  typedef void(ufcx_tabulate_tensor_fused_complex128)(
+      double _Complex* const* restrict A, const double _Complex* const* restrict w,
+      const double _Complex* const* restrict c, const double* restrict coordinate_dofs,
+      const int* restrict entity_local_index,
+      const uint8_t* restrict quadrature_permutation, void* custom_data);
+#endif // __STDC_NO_COMPLEX__
+
+  /// Runtime statistics of an instrumented integral. The counters are
+  /// updated by each call of the tabulate_tensor kernels and are not
+  /// synchronised between threads.
+  typedef struct ufcx_integral_stats
+  {
+    /// Number of tabulated entities
+    uint64_t num_calls;
+
+    /// Clock ticks spent in the kernels, as measured by clock
+    uint64_t ticks;
+
+    /// Clock read on entry and exit of the kernels, e.g. a wrapper of
+    /// the time stamp counter. Ticks are not measured if null.
+    uint64_t (*clock)(void);
+  } ufcx_integral_stats;
+
   typedef struct ufcx_integral
   {
     const bool* enabled_coefficients;
@@ -138,14 +512,144 @@ extern "C"
     ufcx_tabulate_tensor_complex64* tabulate_tensor_complex64;
     ufcx_tabulate_tensor_complex128* tabulate_tensor_complex128;
 #endif // __STDC_NO_COMPLEX__
+
+    /// Batched (multi-entity) versions of tabulate_tensor. Only the
+    /// pointer matching the scalar type of the kernel is non-null.
+    ufcx_tabulate_tensor_batch_float32* tabulate_tensor_batch_float32;
+    ufcx_tabulate_tensor_batch_float64* tabulate_tensor_batch_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_batch_complex64* tabulate_tensor_batch_complex64;
+    ufcx_tabulate_tensor_batch_complex128* tabulate_tensor_batch_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Cell-batched versions of tabulate_tensor for cell integrals,
+    /// tabulating cell_batch_size cells per call with the per-cell
+    /// arguments laid out structure-of-arrays, i.e. A[i][cell],
+    /// w[i][cell] and coordinate_dofs[node][3][cell]. The constants c
+    /// are shared by all cells in the batch. Null if not available.
+    ufcx_tabulate_tensor_float32* tabulate_tensor_cell_batch_float32;
+    ufcx_tabulate_tensor_float64* tabulate_tensor_cell_batch_float64;
+
+    /// Number of cells tabulated per call of tabulate_tensor_cell_batch_*
+    int cell_batch_size;
+
+    /// Matrix-free versions of tabulate_tensor for integrals of bilinear
+    /// forms, see ufcx_form.has_action_kernels. Only the pointer matching
+    /// the scalar type of the kernel is non-null.
+    ufcx_tabulate_action_float32* tabulate_action_float32;
+    ufcx_tabulate_action_float64* tabulate_action_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_action_complex64* tabulate_action_complex64;
+    ufcx_tabulate_action_complex128* tabulate_action_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Versions of tabulate_tensor reading J, detJ and K from the geometry
+    /// computed by ufcx_form.tabulate_geometry_*, see
+    /// ufcx_form.geometry_size. Only the pointer matching the scalar type
+    /// of the kernel is non-null.
+    ufcx_tabulate_tensor_geometry_float32* tabulate_tensor_geometry_float32;
+    ufcx_tabulate_tensor_geometry_float64* tabulate_tensor_geometry_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_geometry_complex64* tabulate_tensor_geometry_complex64;
+    ufcx_tabulate_tensor_geometry_complex128* tabulate_tensor_geometry_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Versions of tabulate_tensor reading the coefficients from their
+    /// global dof arrays through their dofmaps, so that coefficients
+    /// need not be packed. Generated with the option gather_kernels for
+    /// integrals whose coefficients have elements without dof
+    /// transformations. Only the pointer matching the scalar type of the
+    /// kernel is non-null.
+    ufcx_tabulate_tensor_gather_float32* tabulate_tensor_gather_float32;
+    ufcx_tabulate_tensor_gather_float64* tabulate_tensor_gather_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_gather_complex64* tabulate_tensor_gather_complex64;
+    ufcx_tabulate_tensor_gather_complex128* tabulate_tensor_gather_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Versions of tabulate_tensor adding the element tensor directly
+    /// into global values at given positions, without an intermediate
+    /// element tensor. Generated with the option scatter_kernels. Only
+    /// the pointer matching the scalar type of the kernel is non-null.
+    ufcx_tabulate_tensor_scatter_float32* tabulate_tensor_scatter_float32;
+    ufcx_tabulate_tensor_scatter_float64* tabulate_tensor_scatter_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_scatter_complex64* tabulate_tensor_scatter_complex64;
+    ufcx_tabulate_tensor_scatter_complex128* tabulate_tensor_scatter_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Number of quadrature permutations of a facet for which the
+    /// tabulate_tensor_permuted_* kernels are generated, 0 if they are
+    /// not. Generated with the option permuted_kernels for interior facet
+    /// integrals that need facet permutations.
+    int num_quadrature_permutations;
+
+    /// Versions of tabulate_tensor specialised for a pair of quadrature
+    /// permutations (perm0, perm1) of the two facets, at index perm0 *
+    /// num_quadrature_permutations + perm1. The kernels ignore their
+    /// quadrature_permutation argument. Only the pointer matching the
+    /// scalar type of the kernel is non-null.
+    ufcx_tabulate_tensor_float32* const* tabulate_tensor_permuted_float32;
+    ufcx_tabulate_tensor_float64* const* tabulate_tensor_permuted_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_complex64* const* tabulate_tensor_permuted_complex64;
+    ufcx_tabulate_tensor_complex128* const* tabulate_tensor_permuted_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Estimated number of floating point operations of tabulate_tensor
+    /// for one entity
+    int64_t flops_per_call;
+
+    /// Estimated number of bytes of the arguments of tabulate_tensor read
+    /// and written for one entity, without the constants c shared by all
+    /// entities
+    int64_t bytes_per_call;
+
+    /// Runtime statistics, null if the integral is not instrumented
+    ufcx_integral_stats* stats;
+
+    /// Fused integral computing this integral together with the
+    /// integrals of other forms of the module over the same entities,
+    /// or null. Generated with the option fused_kernels.
+    struct ufcx_fused_integral* fused;
+
     bool needs_facet_permutations;
 
+    /// True if the element tensor is symmetric, A[i][j] = A[j][i]. The
+    /// kernels compute one triangle of it and mirror it into the other.
+    bool symmetric;
+
     /// Hash of the coordinate element associated with the geometry of the mesh.
     uint64_t coordinate_element_hash;
 
     uint8_t domain;
   } ufcx_integral;
 
+  /// Integrals of several forms over the same entities of the same
+  /// mesh, e.g. of the residual and the Jacobian of a nonlinear
+  /// problem, computed by one kernel
+  typedef struct ufcx_fused_integral
+  {
+    /// Number of integrals
+    int num_integrals;
+
+    /// The integrals, in the order of the element tensors, coefficients
+    /// and constants passed to tabulate_tensor
+    ufcx_integral** integrals;
+
+    /// Only the pointer matching the scalar type of the kernels is
+    /// non-null.
+    ufcx_tabulate_tensor_fused_float32* tabulate_tensor_float32;
+    ufcx_tabulate_tensor_fused_float64* tabulate_tensor_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_fused_complex64* tabulate_tensor_complex64;
+    ufcx_tabulate_tensor_fused_complex128* tabulate_tensor_complex128;
+#endif // __STDC_NO_COMPLEX__
+
+    /// Estimated number of floating point operations of one call
+    int64_t flops_per_call;
+  } ufcx_fused_integral;
+
   typedef struct ufcx_expression
   {
     /// Evaluate expression into tensor A with compiled evaluation
@@ -162,6 +666,23 @@ extern "C"
     ufcx_tabulate_tensor_complex128* tabulate_tensor_complex128;
 #endif // __STDC_NO_COMPLEX__
 
+    /// Evaluate expression into tensor A for a contiguous batch of
+    /// cells (entities), with the tables loaded once for the batch.
+    /// Only the kernel of the scalar type of the expression is
+    /// generated, with the option cell_batch_size > 1, the others are
+    /// NULL.
+    ///
+    /// @param[out] A Dimensions:
+    /// `A[num_cells][num_points][num_components][num_argument_dofs]`
+    ///
+    /// @see ufcx_tabulate_tensor_batch_float32
+    ufcx_tabulate_tensor_batch_float32* tabulate_tensor_batch_float32;
+    ufcx_tabulate_tensor_batch_float64* tabulate_tensor_batch_float64;
+#ifndef __STDC_NO_COMPLEX__
+    ufcx_tabulate_tensor_batch_complex64* tabulate_tensor_batch_complex64;
+    ufcx_tabulate_tensor_batch_complex128* tabulate_tensor_batch_complex128;
+#endif // __STDC_NO_COMPLEX__
+
     /// Number of coefficients
     int num_coefficients;
 
@@ -261,6 +782,25 @@ extern "C"
     /// form_integrals list
     int* form_integral_offsets;
 
+    /// True if all integrals of this bilinear form provide
+    /// tabulate_action kernels, which apply the element tensors to the
+    /// input vector x of the trial space, so the form can be used
+    /// assembled or matrix-free
+    bool has_action_kernels;
+
+    /// Number of geometry values of a cell, 2 * gdim * tdim + 1 for J,
+    /// detJ and K, if the integrals of this form are over a single affine
+    /// mesh and provide tabulate_tensor_geometry kernels, and 0
+    /// otherwise. The geometry depends on the mesh only, so it can be
+    /// computed once and shared by all forms on the same affine mesh.
+    int geometry_size;
+
+    /// Compute the geometry of a cell from its coordinate dofs. Only the
+    /// pointer matching the geometry type of the kernels is non-null, and
+    /// both are null if geometry_size is 0.
+    ufcx_tabulate_geometry_float32* tabulate_geometry_float32;
+    ufcx_tabulate_geometry_float64* tabulate_geometry_float64;
+
   } ufcx_form;
 
 #ifdef __cplusplus
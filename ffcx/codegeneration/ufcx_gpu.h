@@ -0,0 +1,80 @@
+/// This is UFCx for GPUs
+/// This software is released under the terms of the unlicense (see the file
+/// UNLICENSE).
+///
+/// The FEniCS Project (http://www.fenicsproject.org/) 2025.
+///
+/// Interface of the device kernels generated by FFCx with the
+/// gpu_backend option, in CUDA or HIP source files next to the C code.
+/// Each integral of the C code with a device kernel has a
+/// ufcx_gpu_integral named after it, i.e. <integral>_gpu for the
+/// ufcx_integral <integral>.
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /// Tabulate integral into tensor A for a batch of entities on the
+  /// device, with compiled quadrature rule and single precision
+  ///
+  /// Each thread of a one-dimensional grid tabulates one entity, the
+  /// entity of global thread index i = blockIdx.x * blockDim.x +
+  /// threadIdx.x, and threads with i >= num_entities return. The
+  /// arguments are those of ufcx_tabulate_tensor_batch_float32 in
+  /// device memory, without custom_data: the data of entity i starts at
+  /// A + i * tensor_size, w + i * coefficient_size, coordinate_dofs + i
+  /// * coordinate_dofs_size, entity_local_index + i *
+  /// num_entity_local_indices and quadrature_permutation + i *
+  /// num_quadrature_permutations, with the sizes of ufcx_gpu_integral.
+  ///
+  /// @param[in] num_entities Number of entities in the batch.
+  typedef void(ufcx_gpu_tabulate_tensor_float32)(
+      float* A, const float* w, const float* c, const float* coordinate_dofs,
+      const int* entity_local_index, const uint8_t* quadrature_permutation,
+      int num_entities);
+
+  /// Tabulate integral into tensor A for a batch of entities on the
+  /// device, with compiled quadrature rule and double precision
+  ///
+  /// @see ufcx_gpu_tabulate_tensor_float32
+  typedef void(ufcx_gpu_tabulate_tensor_float64)(
+      double* A, const double* w, const double* c,
+      const double* coordinate_dofs, const int* entity_local_index,
+      const uint8_t* quadrature_permutation, int num_entities);
+
+  /// Device kernel of an integral
+  typedef struct ufcx_gpu_integral
+  {
+    /// Name of the ufcx_integral computed by the kernel
+    const char* name;
+
+    /// Kernel (a __global__ function of type
+    /// ufcx_gpu_tabulate_tensor_<scalar type>), to be launched with
+    /// cudaLaunchKernel or hipLaunchKernel
+    const void* tabulate_tensor;
+
+    /// Number of entries of the element tensor of an entity
+    int tensor_size;
+
+    /// Number of coefficient values of an entity
+    int coefficient_size;
+
+    /// Number of coordinate dof values of an entity
+    int coordinate_dofs_size;
+
+    /// Number of local entity indices of an entity, 0 for cell integrals
+    int num_entity_local_indices;
+
+    /// Number of quadrature permutations of an entity, 0 if the kernel
+    /// does not read them
+    int num_quadrature_permutations;
+  } ufcx_gpu_integral;
+
+#ifdef __cplusplus
+}
+#endif
@@ -61,6 +61,25 @@ def dtype_to_scalar_dtype(dtype: typing.Union[npt.DTypeLike, str]) -> np.dtype:
         raise RuntimeError(f"Cannot get value dtype for '{dtype}'. ")
 
 
+def dtype_with_precision(dtype: typing.Union[npt.DTypeLike, str], precision: str) -> np.dtype:
+    """For a NumPy dtype, return the dtype of the same kind with the given precision.
+
+    Args:
+        dtype: Numpy data type, real or complex.
+        precision: ``"float32"`` or ``"float64"`` for the precision of
+            the real component, or ``"default"`` to keep the precision
+            of ``dtype``.
+
+    Returns:
+        ``numpy.dtype``, complex if ``dtype`` is complex.
+    """
+    if precision == "default":
+        return np.dtype(dtype)
+    if np.issubdtype(dtype, np.complexfloating):
+        return np.dtype({"float32": np.complex64, "float64": np.complex128}[precision])
+    return np.dtype(precision)
+
+
 def numba_ufcx_kernel_signature(dtype: npt.DTypeLike, xdtype: npt.DTypeLike):
     """Return a Numba C signature for the UFCx ``tabulate_tensor`` interface.
 
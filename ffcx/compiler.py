@@ -67,28 +67,57 @@ from __future__ import annotations
 
 import logging
 import typing
+from collections import OrderedDict
 from time import time
 
 import numpy.typing as npt
+import ufl
 
+from ffcx import parallel, profiling
 from ffcx.analysis import analyze_ufl_objects
-from ffcx.codegeneration.codegeneration import generate_code
+from ffcx.codegeneration.codegeneration import generate_code, generate_gpu_code
 from ffcx.formatting import format_code
 from ffcx.ir.representation import compute_ir
+from ffcx.naming import compute_signature, constant_values_signature
 
 logger = logging.getLogger("ffcx")
 
+# Generated code of recently compiled forms and expressions, keyed by
+# signature, options, names and prefix
+_code_cache: OrderedDict[str, tuple[str, str]] = OrderedDict()
+_code_cache_size = 64
+
 
 def _print_timing(stage: int, timing: float) -> None:
     logger.info(f"Compiler stage {stage} finished in {timing:.4f} seconds.")
 
 
+def _code_cache_key(
+    ufl_objects: list[typing.Any],
+    options: dict[str, int | float | npt.DTypeLike],
+    object_names: dict[int, str],
+    prefix: str,
+    constant_values: dict[ufl.Constant, npt.ArrayLike] | None,
+) -> str | None:
+    """Key of the generated code of UFL objects, or None if not cacheable."""
+    for obj in ufl_objects:
+        if not isinstance(obj, ufl.Form) and not (
+            isinstance(obj, tuple) and isinstance(obj[0], ufl.core.expr.Expr)
+        ):
+            return None
+    names = [object_names.get(id(obj), "") for obj in ufl_objects]
+    tag = str(sorted((k, str(v)) for k, v in options.items())) + str(names) + prefix
+    tag += constant_values_signature(ufl_objects, constant_values)
+    return compute_signature(ufl_objects, tag)
+
+
 def compile_ufl_objects(
     ufl_objects: list[typing.Any],
     options: dict[str, int | float | npt.DTypeLike],
     object_names: dict[int, str] | None = None,
     prefix: str | None = None,
     visualise: bool = False,
+    constant_values: dict[ufl.Constant, npt.ArrayLike] | None = None,
 ) -> tuple[str, str]:
     """Generate UFC code for a given UFL objects.
 
@@ -99,28 +128,116 @@ def compile_ufl_objects(
         prefix: Prefix
         options: Options
         visualise: Toggle visualisation
+        constant_values: Known values of Constants of the forms, folded
+          into the generated kernels. The kernels still take all
+          Constants of the forms in their argument c.
     """
     _object_names = object_names if object_names is not None else {}
     _prefix = prefix if prefix is not None else ""
 
+    # Code generated for the same objects earlier in this process
+    key = None
+    if not visualise:
+        key = _code_cache_key(ufl_objects, options, _object_names, _prefix, constant_values)
+    if key is not None and key in _code_cache:
+        logger.info("Reusing code generated by this process, skipping compiler stages 1-4.")
+        _code_cache.move_to_end(key)
+        return _code_cache[key]
+
     # Stage 1: analysis
     cpu_time = time()
-    analysis = analyze_ufl_objects(ufl_objects, options["scalar_type"])  # type: ignore
+    with profiling.timer("analysis", stage=True):
+        analysis = analyze_ufl_objects(
+            ufl_objects,
+            options["scalar_type"],  # type: ignore
+            constant_values,
+            options["geometry_kernels"],  # type: ignore
+        )
     _print_timing(1, time() - cpu_time)
 
-    # Stage 2: intermediate representation
+    # Stage 2: intermediate representation. With several workers, the IR
+    # and the code of the integrals are computed in parallel here.
     cpu_time = time()
-    ir = compute_ir(analysis, _object_names, _prefix, options, visualise)
+    with profiling.timer("compute_ir", stage=True):
+        workers = parallel.num_workers(analysis, options)
+        integral_code = None
+        if workers > 1:
+            logger.info(f"Computing IR and code of integrals with {workers} workers")
+            integral_code = parallel.compute_integral_code(
+                analysis, _prefix, options, visualise, workers
+            )
+        ir = compute_ir(
+            analysis,
+            _object_names,
+            _prefix,
+            options,
+            visualise,
+            integral_code.domains if integral_code is not None else None,
+        )
     _print_timing(2, time() - cpu_time)
 
     # Stage 3: code generation
     cpu_time = time()
-    code = generate_code(ir, options)
+    with profiling.timer("generate_code", stage=True):
+        if integral_code is None:
+            code = generate_code(ir, options)
+        else:
+            code = generate_code(ir, options, integral_code.code, integral_code.table_pool)
     _print_timing(3, time() - cpu_time)
 
     # Stage 4: format code
     cpu_time = time()
-    code_h, code_c = format_code(code)
+    with profiling.timer("format_code", stage=True):
+        code_h, code_c = format_code(code)
     _print_timing(4, time() - cpu_time)
 
+    if key is not None:
+        _code_cache[key] = (code_h, code_c)
+        if len(_code_cache) > _code_cache_size:
+            _code_cache.popitem(last=False)
+
     return code_h, code_c
+
+
+def compile_gpu_code(
+    ufl_objects: list[typing.Any],
+    options: dict[str, int | float | npt.DTypeLike],
+    object_names: dict[int, str] | None = None,
+    prefix: str | None = None,
+    visualise: bool = False,
+    constant_values: dict[ufl.Constant, npt.ArrayLike] | None = None,
+) -> tuple[str, str]:
+    """Generate device code for the integrals of given UFL objects.
+
+    The device kernels are named after the integrals of the code
+    generated by `compile_ufl_objects` with the same arguments.
+
+    Args:
+        ufl_objects: Objects to be compiled, only forms have device code.
+        options: Options, with gpu_backend the language of the code.
+        object_names: Map from object Python id to object name
+        prefix: Prefix
+        visualise: Toggle visualisation
+        constant_values: Known values of Constants of the forms.
+
+    Returns:
+        Header and source file contents.
+    """
+    if options["gpu_backend"] == "none":
+        raise ValueError("No device code for gpu_backend 'none'.")
+    _object_names = object_names if object_names is not None else {}
+    _prefix = prefix if prefix is not None else ""
+
+    with profiling.timer("analysis", stage=True):
+        analysis = analyze_ufl_objects(
+            ufl_objects,
+            options["scalar_type"],  # type: ignore
+            constant_values,
+            options["geometry_kernels"],  # type: ignore
+        )
+    with profiling.timer("compute_ir", stage=True):
+        ir = compute_ir(analysis, _object_names, _prefix, options, visualise)
+    with profiling.timer("generate_code", stage=True):
+        code = generate_gpu_code(ir, options)
+    with profiling.timer("format_code", stage=True):
+        return format_code(code)
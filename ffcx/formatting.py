@@ -18,7 +18,10 @@ from __future__ import annotations
 import logging
 import os
 
+from ffcx import __version__ as FFCX_VERSION
+from ffcx.codegeneration.C import file_template
 from ffcx.codegeneration.codegeneration import CodeBlocks
+from ffcx.codegeneration.GPU import file_template as gpu_file_template
 
 logger = logging.getLogger("ffcx")
 
@@ -44,6 +47,27 @@ def write_code(code_h: str, code_c: str, prefix: str, output_dir: str) -> None:
     _write_file(code_c, prefix, ".c", output_dir)
 
 
+def write_gpu_code(code_h: str, code_gpu: str, prefix: str, output_dir: str, backend: str) -> None:
+    """Write device code to files, named after the C code files."""
+    _write_file(code_h, prefix, "_gpu.h", output_dir)
+    _write_file(code_gpu, prefix, "." + gpu_file_template.extensions[backend], output_dir)
+
+
+def write_cmake_project(name: str, prefixes: list[str], output_dir: str) -> None:
+    """Write a CMake project building the C code of given prefixes into a library.
+
+    The library links to the ufcx CMake target (see cmake/CMakeLists.txt)
+    and installs the headers of the code with it.
+    """
+    project = file_template.cmake_project.format(
+        ffcx_version=FFCX_VERSION,
+        name=name,
+        sources=" ".join(f"{prefix}.c" for prefix in prefixes),
+        headers=";".join(f"{prefix}.h" for prefix in prefixes),
+    )
+    _write_file(project, "CMakeLists", ".txt", output_dir)
+
+
 def _write_file(output: str, prefix: str, postfix: str, output_dir: str) -> None:
     """Write generated code to file."""
     filename = os.path.join(output_dir, prefix + postfix)
@@ -5,6 +5,7 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 """Algorithms for factorizing argument dependent monomials."""
 
+import array
 import logging
 from functools import singledispatch
 
@@ -237,6 +238,7 @@ def compute_argument_factorization(S, rank):
     """
     # Extract argument component subgraph
     arg_indices = build_argument_indices(S)
+    arg_positions = {si: ai for ai, si in enumerate(arg_indices)}
     AV = [S.nodes[i]["expression"] for i in arg_indices]
 
     # Data structure for building non-argument factors
@@ -263,11 +265,12 @@ def compute_argument_factorization(S, rank):
     # is a linear combination of multiple argkey configurations
 
     # Factorize each subexpression in order:
+    out_edges = S.out_edges
     for si, attr in S.nodes.items():
-        deps = S.out_edges[si]
+        deps = out_edges[si]
         v = attr["expression"]
 
-        if si in arg_indices:
+        if si in arg_positions:
             assert len(deps) == 0
             # v is a modified Argument
             factors = {(si,): one_index}
@@ -313,7 +316,7 @@ def compute_argument_factorization(S, rank):
             # Map argkeys from indices into SV to indices into AV,
             # and resort keys for canonical representation
             for argkey, fi in S.nodes[S_target]["factors"].items():
-                ai_fi = {tuple(sorted(arg_indices.index(si) for si in argkey)): fi}
+                ai_fi = {tuple(sorted(arg_positions[si] for si in argkey)): fi}
                 for comp in S.nodes[S_target]["component"]:
                     if factors.get(comp):
                         factors[comp].update(ai_fi)
@@ -330,10 +333,14 @@ def compute_argument_factorization(S, rank):
             F.nodes[fi]["component"].append(comp)
 
     # Compute dependencies in FV
+    sources = array.array("q")
+    targets = array.array("q")
     for i, v in F.nodes.items():
         expr = v["expression"]
         if not expr._ufl_is_terminal_ and not expr._ufl_is_terminal_modifier_:
             for o in expr.ufl_operands:
-                F.add_edge(i, F.e2i[o])
+                sources.append(i)
+                targets.append(F.e2i[o])
+    F.add_edges(sources, targets)
 
     return F
@@ -5,10 +5,12 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 """Linearized data structure for the computational graph."""
 
+import array
 import logging
 import typing
 
 import numpy as np
+import numpy.typing as npt
 import ufl
 
 from ffcx.ir.analysis.modified_terminals import is_modified_terminal
@@ -18,38 +20,119 @@ from ffcx.ir.analysis.valuenumbering import ValueNumberer
 logger = logging.getLogger("ffcx")
 
 
+class Adjacency:
+    """Edges of a graph in compressed sparse row (CSR) format.
+
+    The neighbours of node i are ``targets[offsets[i]:offsets[i + 1]]``,
+    in the order in which the edges were added.
+    """
+
+    def __init__(self, num_nodes: int, sources: npt.ArrayLike, targets: npt.ArrayLike):
+        """Initialise.
+
+        Args:
+            num_nodes: Number of nodes.
+            sources: Source node of each edge.
+            targets: Target node of each edge.
+        """
+        sources = np.asarray(sources, dtype=np.int64)
+        order = np.argsort(sources, kind="stable")
+        self.targets = np.asarray(targets, dtype=np.int64)[order]
+        self.offsets = np.zeros(num_nodes + 1, dtype=np.int64)
+        np.cumsum(np.bincount(sources, minlength=num_nodes), out=self.offsets[1:])
+
+    def __getitem__(self, node: int) -> list[int]:
+        """Neighbours of a node."""
+        return self.targets[self.offsets[node] : self.offsets[node + 1]].tolist()
+
+    def __len__(self) -> int:
+        """Number of nodes."""
+        return len(self.offsets) - 1
+
+    def items(self) -> typing.Iterator[tuple[int, list[int]]]:
+        """Iterate over the nodes and their neighbours."""
+        targets = self.targets.tolist()
+        offsets = self.offsets.tolist()
+        for node in range(len(self)):
+            yield node, targets[offsets[node] : offsets[node + 1]]
+
+
 class ExpressionGraph:
     """A directed multi-edge graph.
 
     ExpressionGraph allows multiple edges between the same nodes,
     and respects the insertion order of nodes and edges.
+
+    The nodes are numbered in insertion order and their properties are
+    stored in dictionaries. The edges are appended to flat integer
+    arrays and the adjacency lists ``out_edges`` and ``in_edges`` are
+    built from them in CSR format when first used after a change, so
+    that graphs with very many nodes do not need per-node edge lists.
     """
 
     def __init__(self):
         """Initialise."""
         # Data structures for directed multi-edge graph
         self.nodes = {}
-        self.out_edges = {}
-        self.in_edges = {}
         self.e2i = {}
+        self._sources = array.array("q")
+        self._targets = array.array("q")
+        self._out_edges: typing.Optional[Adjacency] = None
+        self._in_edges: typing.Optional[Adjacency] = None
 
     def number_of_nodes(self):
         """Get number of nodes."""
         return len(self.nodes)
 
+    def number_of_edges(self):
+        """Get number of edges."""
+        return len(self._sources)
+
     def add_node(self, key, **kwargs):
         """Add a node with optional properties."""
+        if key != len(self.nodes):
+            raise ValueError("Nodes must be numbered in insertion order.")
         self.nodes[key] = kwargs
-        self.out_edges[key] = []
-        self.in_edges[key] = []
+        self._out_edges = None
+        self._in_edges = None
 
     def add_edge(self, node1, node2):
         """Add a directed edge from node1 to node2."""
         if node1 not in self.nodes or node2 not in self.nodes:
             raise KeyError("Adding edge to unknown node")
-
-        self.out_edges[node1] += [node2]
-        self.in_edges[node2] += [node1]
+        self._sources.append(node1)
+        self._targets.append(node2)
+        self._out_edges = None
+        self._in_edges = None
+
+    def add_edges(self, sources: npt.ArrayLike, targets: npt.ArrayLike):
+        """Add directed edges from each node of sources to the node of targets."""
+        sources = np.asarray(sources, dtype=np.int64)
+        targets = np.asarray(targets, dtype=np.int64)
+        if sources.shape != targets.shape:
+            raise ValueError("Expecting as many sources as targets.")
+        if sources.size > 0:
+            nodes = np.concatenate([sources, targets])
+            if nodes.min() < 0 or nodes.max() >= len(self.nodes):
+                raise KeyError("Adding edge to unknown node")
+        self._sources.extend(sources.tolist())
+        self._targets.extend(targets.tolist())
+        self._out_edges = None
+        self._in_edges = None
+
+    @property
+    def out_edges(self) -> Adjacency:
+        """Targets of the edges out of each node."""
+        if self._out_edges is None:
+            self._out_edges = Adjacency(len(self.nodes), self._sources, self._targets)
+        return self._out_edges
+
+    @property
+    def in_edges(self) -> Adjacency:
+        """Sources of the edges into each node."""
+        if self._in_edges is None:
+            self._in_edges = Adjacency(len(self.nodes), self._targets, self._sources)
+        return self._in_edges
 
 
 def build_graph_vertices(expressions, skip_terminal_modifiers=False) -> ExpressionGraph:
@@ -88,19 +171,18 @@ def build_scalar_graph(expression) -> ExpressionGraph:
     G = build_graph_vertices(scalar_expressions, skip_terminal_modifiers=True)
 
     # Compute graph edges
-    V_deps: list[typing.Union[tuple[()], list[int]]] = []
+    sources = array.array("q")
+    targets = array.array("q")
     for i, v in G.nodes.items():
         expr = v["expression"]
         if expr._ufl_is_terminal_ or expr._ufl_is_terminal_modifier_:
-            V_deps.append(())
-        else:
-            V_deps.append([G.e2i[o] for o in expr.ufl_operands])
-
-    for i, edges in enumerate(V_deps):
-        for j in edges:
-            if i == j:
-                continue
-            G.add_edge(i, j)
+            continue
+        for o in expr.ufl_operands:
+            j = G.e2i[o]
+            if i != j:
+                sources.append(i)
+                targets.append(j)
+    G.add_edges(sources, targets)
 
     return G
 
@@ -5,6 +5,7 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 """Tools for precomputed tables of terminal values."""
 
+import itertools
 import logging
 import typing
 
@@ -56,6 +57,8 @@ class UniqueTableReferenceT(typing.NamedTuple):
     has_tensor_factorisation: bool
     tensor_factors: typing.Optional[list[typing.Any]]
     tensor_permutation: typing.Optional[np.typing.NDArray[np.int32]]
+    dofmap: typing.Optional[tuple[int, ...]] = None
+    facet_tensor_dofs: typing.Optional[npt.NDArray[np.int32]] = None
 
 
 def equal_tables(a, b, rtol=default_rtol, atol=default_atol):
@@ -300,6 +303,109 @@ def permute_quadrature_quadrilateral(points, reflections=0, rotations=0):
     return output
 
 
+def permute_quadrature_facet(points, cell, integral_type):
+    """Permute the points of a facet rule for each quadrature permutation of the facets."""
+    if integral_type != "interior_facet":
+        return [points]
+    if cell.cellname() == "quadrilateral":
+        return [permute_quadrature_interval(points, ref) for ref in range(2)]
+    assert cell.cellname() == "hexahedron"
+    return [
+        permute_quadrature_quadrilateral(points, ref, rot) for rot in range(4) for ref in range(2)
+    ]
+
+
+def get_facet_tensor_factor_values(quadrature_rule, cell, integral_type, factors, derivatives):
+    """Tabulate the 1D factors of a tensor product element on the facets of a cell.
+
+    Each facet of a quadrilateral or hexahedron is normal to one axis
+    of the cell, and the directions of the facet rule lie along the
+    others. The factors are returned in the facet-local order, normal
+    first, for each quadrature permutation and facet, with the element
+    dof of each dof of the facet-local factors.
+
+    Args:
+        quadrature_rule: Tensor product rule on the facets.
+        cell: The cell.
+        integral_type: Facet integral type.
+        factors: The 1D elements of the tensor product element.
+        derivatives: Derivative order in each cell direction.
+
+    Returns:
+        The factor tables, of shape ``(num_perms, num_facets, num_points,
+        num_dofs)``, and the dofs, of shape ``(num_perms, num_facets,
+        num_dofs)``, or ``None`` if the factors differ in size.
+    """
+    tdim = cell.topological_dimension()
+    sizes = [factor.dim for factor in factors]
+    if len(set(sizes)) != 1:
+        return None
+    strides = [int(np.prod(sizes[k + 1 :])) for k in range(tdim)]
+    # The origin and unit directions of the facet
+    probes = np.vstack([np.zeros(tdim - 1), np.eye(tdim - 1)])
+    permuted_probes = permute_quadrature_facet(probes, cell, integral_type)
+
+    values: list[list[list[npt.NDArray[np.float64]]]] = [[] for _ in range(tdim)]
+    dofs = []
+    for probe in permuted_probes:
+        for v in values:
+            v.append([])
+        dofs.append([])
+        for facet in range(cell.num_facets()):
+            x = map_integral_points(probe, integral_type, cell, facet)
+            origin, directions = x[0], x[1:] - x[0]
+            axes = []
+            for direction in directions:
+                (axis,) = np.flatnonzero(~np.isclose(direction, 0))
+                axes.append(int(axis))
+            (normal,) = set(range(tdim)) - set(axes)
+            points = [origin[normal : normal + 1]] + [
+                origin[axis] + direction[axis] * factor[0][:, 0]
+                for axis, direction, factor in zip(axes, directions, quadrature_rule.tensor_factors)
+            ]
+            axes = [normal] + axes
+            for k, (axis, pts) in enumerate(zip(axes, points)):
+                d = derivatives[axis]
+                values[k][-1].append(factors[axis].tabulate(d, pts.reshape(-1, 1))[d])
+            dofs[-1].append(
+                [
+                    sum(i * strides[axis] for i, axis in zip(index, axes))
+                    for index in itertools.product(*[range(sizes[axis]) for axis in axes])
+                ]
+            )
+
+    tables = [clamp_table_small_numbers(np.array(v)) for v in values]
+    return tables, np.array(dofs, dtype=np.int32)
+
+
+def get_unique_tensor_factor(values, all_tensor_factors, mt_tables):
+    """Get the reference to a factor table, reusing an existing identical factor."""
+    is_permuted = is_permuted_table(values)
+    if not is_permuted:
+        values = values[:1]
+    for tensor_factor in all_tensor_factors:
+        if tensor_factor.values.shape == values.shape and np.allclose(
+            tensor_factor.values, values
+        ):
+            return tensor_factor
+    ut = UniqueTableReferenceT(
+        f"FE_TF{len(all_tensor_factors)}",
+        values,
+        None,
+        None,
+        None,
+        False,
+        False,
+        is_permuted,
+        False,
+        None,
+        None,
+    )
+    all_tensor_factors.append(ut)
+    mt_tables[ut.name] = ut
+    return ut
+
+
 def build_optimized_tables(
     quadrature_rule: QuadratureRule,
     cell: ufl.Cell,
@@ -353,7 +459,11 @@ def build_optimized_tables(
     _existing_tables = existing_tables.copy()
 
     all_tensor_factors: list[UniqueTableReferenceT] = []
-    tensor_n = 0
+
+    # Rank of the integrand, on facets only the test function of linear
+    # forms is contracted in stages
+    terminals = [mt.terminal for mt in modified_terminals]
+    rank = len({t.number() for t in terminals if isinstance(t, ufl.classes.Argument)})
 
     for mt in modified_terminals:
         res = analysis.get(mt)
@@ -474,6 +584,58 @@ def build_optimized_tables(
             )
         # Clean up table
         tbl = clamp_table_small_numbers(t["array"], rtol=rtol, atol=atol)
+
+        # Split varying facet tables of coefficients and of the test
+        # function of linear forms into the 1D factors on each facet
+        facet_factors = None
+        if (
+            use_sum_factorization
+            and integral_type in ("exterior_facet", "interior_facet")
+            and quadrature_rule.has_tensor_factors
+            and codim == 0
+            and not is_mixed_dim
+            and element.has_tensor_product_factorisation
+            and len(element.get_tensor_product_representation()) == 1
+            and (
+                isinstance(mt.terminal, ufl.classes.Coefficient)
+                or (isinstance(mt.terminal, ufl.classes.Argument) and rank == 1)
+            )
+            and analyse_table_type(tbl) == "varying"
+        ):
+            facet_factors = get_facet_tensor_factor_values(
+                quadrature_rule,
+                cell,
+                integral_type,
+                element.get_tensor_product_representation()[0],
+                local_derivatives,
+            )
+
+        # Drop the dofs that are zero at all points on all entities, e.g.
+        # the bubble of an enriched element in facet integrals or the
+        # facet dofs of H(div) elements in tangential components. Tables
+        # split into tensor factors keep all dofs.
+        offset = t["offset"]
+        block_size = t["stride"]
+        dofmap = None
+        if (
+            integral_type not in ("expression", *ufl.custom_integral_types)
+            and isinstance(mt.terminal, ufl.classes.FormArgument)
+            and not (
+                use_sum_factorization
+                and element.has_tensor_product_factorisation
+                and integral_type == "cell"
+            )
+            and facet_factors is None
+        ):
+            tbl, dofs = compress_table(tbl)
+            if len(set(np.diff(dofs))) <= 1:
+                # Equally spaced dofs are described by offset and stride
+                offset += block_size * dofs[0]
+                if len(dofs) > 1:
+                    block_size *= dofs[1] - dofs[0]
+            else:
+                dofmap = dofs
+
         tabletype = analyse_table_type(tbl)
 
         if tabletype in piecewise_ttypes:
@@ -501,7 +663,11 @@ def build_optimized_tables(
 
         cell_offset = 0
 
-        if use_sum_factorization and (not quadrature_rule.has_tensor_factors):
+        if (
+            use_sum_factorization
+            and integral_type == "cell"
+            and (not quadrature_rule.has_tensor_factors)
+        ):
             raise RuntimeError("Sum factorization not available for this quadrature rule.")
 
         tensor_factors: typing.Optional[list[UniqueTableReferenceT]] = None
@@ -510,6 +676,7 @@ def build_optimized_tables(
             use_sum_factorization
             and element.has_tensor_product_factorisation
             and len(element.get_tensor_product_representation()) == 1
+            and integral_type == "cell"
             and quadrature_rule.has_tensor_factors
         ):
             factors = element.get_tensor_product_representation()
@@ -520,39 +687,28 @@ def build_optimized_tables(
                 d = local_derivatives[i]
                 sub_tbl = j.tabulate(d, pts)[d]
                 sub_tbl = sub_tbl.reshape(1, 1, sub_tbl.shape[0], sub_tbl.shape[1])
-                for tensor_factor in all_tensor_factors:
-                    if tensor_factor.values.shape == sub_tbl.shape and np.allclose(
-                        tensor_factor.values, sub_tbl
-                    ):
-                        tensor_factors.append(tensor_factor)
-                        break
-                else:
-                    ut = UniqueTableReferenceT(
-                        f"FE_TF{tensor_n}",
-                        sub_tbl,
-                        None,
-                        None,
-                        None,
-                        False,
-                        False,
-                        False,
-                        False,
-                        None,
-                        None,
-                    )
-                    all_tensor_factors.append(ut)
-                    tensor_factors.append(ut)
-                    mt_tables[ut.name] = ut
-                    tensor_n += 1
+                tensor_factors.append(
+                    get_unique_tensor_factor(sub_tbl, all_tensor_factors, mt_tables)
+                )
 
             tensor_perm = factors[0][1]
 
+        facet_tensor_dofs = None
+        if facet_factors is not None:
+            factor_values, facet_tensor_dofs = facet_factors
+            tensor_factors = [
+                get_unique_tensor_factor(values, all_tensor_factors, mt_tables)
+                for values in factor_values
+            ]
+            if all(np.array_equal(d, facet_tensor_dofs[0]) for d in facet_tensor_dofs):
+                # The facet dofs are the same for all quadrature permutations
+                facet_tensor_dofs = facet_tensor_dofs[:1]
+
         if mt.restriction == "-" and isinstance(mt.terminal, ufl.classes.FormArgument):
             # offset = 0 or number of element dofs, if restricted to "-"
             cell_offset = element.dim
 
-        offset = cell_offset + t["offset"]
-        block_size = t["stride"]
+        offset += cell_offset
 
         # tables is just np.arrays, mt_tables hold metadata too
         mt_tables[mt] = UniqueTableReferenceT(
@@ -567,11 +723,26 @@ def build_optimized_tables(
             tensor_factors is not None,
             tensor_factors,
             tensor_perm,
+            dofmap,
+            facet_tensor_dofs,
         )
 
     return mt_tables
 
 
+def compress_table(table):
+    """Remove the columns of a table that are zero at all points.
+
+    Returns:
+        The table of the remaining columns, and the dofs of these
+        columns. Tables that are zero everywhere are not compressed.
+    """
+    dofs = tuple(int(i) for i in np.flatnonzero(np.any(table != 0, axis=(0, 1, 2))))
+    if not dofs:
+        return table, tuple(range(table.shape[-1]))
+    return table[..., list(dofs)], dofs
+
+
 def is_zeros_table(table, rtol=default_rtol, atol=default_atol):
     """Check if table values are all zero."""
     return np.prod(table.shape) == 0 or np.allclose(
@@ -16,6 +16,7 @@ from ufl.algorithms.balancing import balance_modifiers
 from ufl.checks import is_cellwise_constant
 from ufl.classes import QuadratureWeight
 
+from ffcx import profiling
 from ffcx.definitions import entity_types
 from ffcx.ir.analysis.factorization import compute_argument_factorization
 from ffcx.ir.analysis.graph import build_scalar_graph
@@ -49,6 +50,7 @@ class BlockDataT(typing.NamedTuple):
     is_uniform: bool
     ma_data: tuple[ModifiedArgumentDataT, ...]  # used in "full", "safe" and "partial"
     is_permuted: bool  # Do quad points on facets need to be permuted?
+    is_symmetric: bool = False  # block is its own transpose
 
 
 def compute_integral_ir(
@@ -98,18 +100,19 @@ def compute_integral_ir(
                 if domain.topological_dimension() != cell.topological_dimension():
                     is_mixed_dim = True
 
-            mt_table_reference = build_optimized_tables(
-                quadrature_rule,
-                cell,
-                integral_type,
-                entity_type,
-                initial_terminals.values(),
-                ir["unique_tables"][integral_domain],
-                use_sum_factorization=p["sum_factorization"],
-                is_mixed_dim=is_mixed_dim,
-                rtol=p["table_rtol"],
-                atol=p["table_atol"],
-            )
+            with profiling.timer("build_optimized_tables"):
+                mt_table_reference = build_optimized_tables(
+                    quadrature_rule,
+                    cell,
+                    integral_type,
+                    entity_type,
+                    initial_terminals.values(),
+                    ir["unique_tables"][integral_domain],
+                    use_sum_factorization=p["sum_factorization"],
+                    is_mixed_dim=is_mixed_dim,
+                    rtol=p["table_rtol"],
+                    atol=p["table_atol"],
+                )
 
             # Fetch unique tables for this quadrature rule
             table_types = {v.name: v.ttype for v in mt_table_reference.values()}
@@ -151,7 +154,10 @@ def compute_integral_ir(
 
             # Compute factorization of arguments
             rank = len(argument_shape)
-            F = compute_argument_factorization(S, rank)
+            with profiling.timer("compute_argument_factorization"):
+                F = compute_argument_factorization(S, rank)
+            profiling.record("scalar_graph_nodes", len(S.nodes))
+            profiling.record("factorization_nodes", len(F.nodes))
 
             # Get the 'target' nodes that are factors of arguments, and insert in dict
             FV_targets = [i for i, v in F.nodes.items() if v.get("target", False)]
@@ -214,7 +220,8 @@ def compute_integral_ir(
                     assert begin is not None
                     num_dofs = tr.values.shape[3]
                     assert tr.block_size is not None
-                    dofmap = tuple(begin + i * tr.block_size for i in range(num_dofs))
+                    dofs = range(num_dofs) if tr.dofmap is None else tr.dofmap
+                    dofmap = tuple(begin + i * tr.block_size for i in dofs)
                     _blockmap.append(dofmap)
                 blockmap = tuple(_blockmap)
 
@@ -311,9 +318,75 @@ def compute_integral_ir(
                     "+" in restrictions and "-" in restrictions
                 ) or is_mixed_dim
 
+    # Compute one triangle of the element tensor of symmetric bilinear forms
+    ir["symmetric"] = (
+        integral_type != "expression"
+        and len(argument_shape) == 2
+        and argument_shape[0] == argument_shape[1]
+        and mark_symmetric_blocks(ir["integrand"])
+    )
+
     return ir
 
 
+def mark_symmetric_blocks(integrands: dict) -> bool:
+    """Mark the blocks of an integral with a symmetric element tensor.
+
+    The element tensor is symmetric if, for each quadrature rule, each
+    block is either its own transpose, with the same table, dofs and
+    restriction for both arguments, or has a transposed block with the
+    same factor. One block of each transposed pair is marked as
+    transposed, to be computed by mirroring the other, and the blocks
+    which are their own transpose are marked as symmetric.
+
+    Args:
+        integrands: IR of the integrands by domain and quadrature rule,
+            modified in place if the element tensor is symmetric.
+
+    Returns:
+        True if the element tensor is symmetric.
+    """
+
+    def block_key(blockdata, modified_arguments):
+        arguments = []
+        for mad in blockdata.ma_data:
+            tr = mad.tabledata
+            restriction = modified_arguments[mad.ma_index].restriction
+            arguments.append((tr.name, tr.offset, tr.block_size, tr.dofmap, restriction))
+        return tuple(arguments), tuple(blockdata.factor_indices_comp_indices)
+
+    def transpose(key):
+        arguments, factors = key
+        return arguments[::-1], factors
+
+    keys = {}
+    for rule_key, integrand in integrands.items():
+        modified_arguments = integrand["modified_arguments"]
+        for contributions in integrand["block_contributions"].values():
+            for blockdata in contributions:
+                if any(mad.tabledata.has_tensor_factorisation for mad in blockdata.ma_data):
+                    return False
+        rule_keys = [
+            block_key(blockdata, modified_arguments)
+            for contributions in integrand["block_contributions"].values()
+            for blockdata in contributions
+        ]
+        if collections.Counter(rule_keys) != collections.Counter(map(transpose, rule_keys)):
+            return False
+        keys[rule_key] = rule_keys
+
+    for rule_key, integrand in integrands.items():
+        rule_keys = iter(keys[rule_key])
+        for contributions in integrand["block_contributions"].values():
+            for i, blockdata in enumerate(contributions):
+                key = next(rule_keys)
+                contributions[i] = blockdata._replace(
+                    transposed=repr(key) > repr(transpose(key)),
+                    is_symmetric=key == transpose(key),
+                )
+    return True
+
+
 def analyse_dependencies(F, mt_unique_table_reference):
     """Analyse dependencies.
 
@@ -27,10 +27,11 @@ import basix
 import numpy as np
 import numpy.typing as npt
 import ufl
+from ufl.algorithms import extract_arguments, replace
 from ufl.classes import Integral
 from ufl.sorting import sorted_expr_sum
 
-from ffcx import naming
+from ffcx import naming, profiling
 from ffcx.analysis import UFLData
 from ffcx.definitions import entity_types
 from ffcx.ir.integral import compute_integral_ir
@@ -102,6 +103,10 @@ class FormIR(typing.NamedTuple):
     integral_names: dict[str, list[str]]
     integral_domains: dict[str, list[basix.CellType]]
     subdomain_ids: dict[str, list[int]]
+    has_action_kernels: bool
+    # Shape (gdim, tdim) of the geometry read by the tabulate_tensor_geometry
+    # kernels of the integrals, empty if they are not generated
+    geometry_shape: tuple[int, ...]
 
 
 class QuadratureIR(typing.NamedTuple):
@@ -126,6 +131,8 @@ class CommonExpressionIR(typing.NamedTuple):
     integrand: dict[tuple[basix.CellType, QuadratureRule], dict]
     name: str
     needs_facet_permutations: bool
+    # Element tensor is symmetric, and one triangle of it is computed
+    symmetric: bool
     shape: list[int]
     coordinate_element_hash: str
 
@@ -136,6 +143,28 @@ class IntegralIR(typing.NamedTuple):
     expression: CommonExpressionIR
     rank: int
     enabled_coefficients: list[bool]
+    coefficient_size: int
+    coordinate_dofs_size: int
+    # Action y = A x of a bilinear form integral, with the trial function
+    # replaced by the coefficient x
+    action: typing.Optional[CommonExpressionIR]
+    action_coefficient: typing.Optional[ufl.Coefficient]
+    # Size of the precomputed geometry of a cell read by the
+    # tabulate_tensor_geometry kernel, 0 if it is not generated
+    geometry_size: int
+    # Name of the fused integral also computing this integral, or None
+    fused_integral: typing.Optional[str]
+
+
+class FusedIntegralIR(typing.NamedTuple):
+    """Intermediate representation of a fused integral.
+
+    The integrals of several forms over the same entities, computed by a
+    single kernel writing one element tensor per integral.
+    """
+
+    name: str
+    integrals: list[IntegralIR]
 
 
 class ExpressionIR(typing.NamedTuple):
@@ -146,12 +175,17 @@ class ExpressionIR(typing.NamedTuple):
     coefficient_names: list[str]
     constant_names: list[str]
     name_from_uflfile: str
+    # Sizes of the per-cell coefficient and geometry arguments, used as
+    # strides by the batched kernel
+    coefficient_size: int
+    coordinate_dofs_size: int
 
 
 class DataIR(typing.NamedTuple):
     """Intermediate representation of data."""
 
     integrals: list[IntegralIR]
+    fused_integrals: list[FusedIntegralIR]
     forms: list[FormIR]
     expressions: list[ExpressionIR]
 
@@ -162,8 +196,20 @@ def compute_ir(
     prefix: str,
     options: dict[str, typing.Union[npt.DTypeLike, int, float]],
     visualise: bool,
+    integral_domains: typing.Optional[dict[str, set[basix.CellType]]] = None,
 ) -> DataIR:
-    """Compute intermediate representation."""
+    """Compute intermediate representation.
+
+    Args:
+        analysis: Analysed UFL objects.
+        object_names: Map from object Python id to object name.
+        prefix: Prefix of the names of the generated objects.
+        options: Options.
+        visualise: Toggle visualisation.
+        integral_domains: Cell types of each integral, by name, if the
+            IR and code of the integrals are computed separately (see
+            `ffcx.parallel`). No integral IR is computed then.
+    """
     logger.info(79 * "*")
     logger.info("Compiler stage 2: Computing intermediate representation of objects")
     logger.info(79 * "*")
@@ -172,31 +218,46 @@ def compute_ir(
     # NOTE: This is done here for performance reasons, because repeated
     # calls within each IR computation would be expensive due to UFL
     # signature computations.
-    integral_names = {}
-    form_names = {}
-    for fd_index, fd in enumerate(analysis.form_data):
-        form_names[fd_index] = naming.form_name(fd.original_form, fd_index, prefix)
-        for itg_index, itg_data in enumerate(fd.integral_data):
-            integral_names[(fd_index, itg_index)] = naming.integral_name(
-                fd.original_form, itg_data.integral_type, fd_index, itg_data.subdomain_id, prefix
-            )
+    integral_names = compute_integral_names(analysis, prefix)
+    form_names = {
+        fd_index: naming.form_name(fd.original_form, fd_index, prefix)
+        for fd_index, fd in enumerate(analysis.form_data)
+    }
 
+    irs: list[list[IntegralIR]] = [[] for _ in analysis.form_data]
+    if integral_domains is None:
+        irs = [
+            _compute_integral_ir(
+                fd,
+                i,
+                analysis.element_numbers,
+                integral_names,
+                options,
+                visualise,
+            )
+            for (i, fd) in enumerate(analysis.form_data)
+        ]
+    fused_groups = _fused_integral_groups(analysis, irs) if options["fused_kernels"] else []
+    fused_names = {name: f"fused_{group[0]}" for group in fused_groups for name in group}
     irs = [
-        _compute_integral_ir(
-            fd,
-            i,
-            analysis.element_numbers,
-            integral_names,
-            options,
-            visualise,
-        )
-        for (i, fd) in enumerate(analysis.form_data)
+        [ir._replace(fused_integral=fused_names.get(ir.expression.name)) for ir in form_irs]
+        for form_irs in irs
     ]
     ir_integrals = list(itertools.chain(*irs))
+    integrals_by_name = {ir.expression.name: ir for ir in ir_integrals}
+    ir_fused_integrals = [
+        FusedIntegralIR(
+            name=fused_names[group[0]], integrals=[integrals_by_name[name] for name in group]
+        )
+        for group in fused_groups
+    ]
 
-    integral_domains = {
-        i.expression.name: set(j[0] for j in i.expression.integrand.keys()) for a in irs for i in a
-    }
+    if integral_domains is None:
+        integral_domains = {
+            i.expression.name: set(j[0] for j in i.expression.integrand.keys())
+            for a in irs
+            for i in a
+        }
 
     ir_forms = [
         _compute_form_ir(
@@ -207,6 +268,7 @@ def compute_ir(
             integral_names,
             integral_domains,
             object_names,
+            options,
         )
         for (i, fd) in enumerate(analysis.form_data)
     ]
@@ -226,11 +288,70 @@ def compute_ir(
 
     return DataIR(
         integrals=ir_integrals,
+        fused_integrals=ir_fused_integrals,
         forms=ir_forms,
         expressions=ir_expressions,
     )
 
 
+def compute_integral_names(analysis: UFLData, prefix: str) -> dict[tuple[int, int], str]:
+    """Names of the integrals, by form index and integral data index."""
+    integral_names = {}
+    for fd_index, fd in enumerate(analysis.form_data):
+        for itg_index, itg_data in enumerate(fd.integral_data):
+            integral_names[(fd_index, itg_index)] = naming.integral_name(
+                fd.original_form, itg_data.integral_type, fd_index, itg_data.subdomain_id, prefix
+            )
+    return integral_names
+
+
+def compute_integral_data_ir(
+    analysis: UFLData,
+    form_index: int,
+    integral_index: int,
+    integral_names: dict[tuple[int, int], str],
+    options: dict[str, typing.Union[npt.DTypeLike, int, float]],
+    visualise: bool,
+) -> IntegralIR:
+    """Compute intermediate representation of one integral data of a form."""
+    (ir,) = _compute_integral_ir(
+        analysis.form_data[form_index],
+        form_index,
+        analysis.element_numbers,
+        integral_names,
+        options,
+        visualise,
+        integral_index,
+    )
+    return ir
+
+
+def _fused_integral_groups(analysis: UFLData, irs: list[list[IntegralIR]]) -> list[list[str]]:
+    """Group the integrals of different forms over the same entities.
+
+    Integrals of the same type over the same subdomains of the same mesh
+    and cell types are fused, e.g. the integrals of the residual and the
+    Jacobian of a nonlinear problem.
+
+    Returns:
+        The names of the integrals of each group of at least two integrals.
+    """
+    groups: dict[tuple, list[str]] = {}
+    for fd, form_irs in zip(analysis.form_data, irs):
+        for itg_data, ir in zip(fd.integral_data, form_irs):
+            if itg_data.integral_type not in ("cell", "exterior_facet", "interior_facet"):
+                continue
+            key = (
+                itg_data.integral_type,
+                tuple(itg_data.subdomain_id),
+                itg_data.domain,
+                frozenset(cell for cell, _ in ir.expression.integrand),
+            )
+            groups.setdefault(key, []).append(ir.expression.name)
+
+    return [names for names in groups.values() if len(names) > 1]
+
+
 def _compute_integral_ir(
     form_data,
     form_index,
@@ -238,8 +359,13 @@ def _compute_integral_ir(
     integral_names,
     options,
     visualise,
+    integral_index=None,
 ) -> list[IntegralIR]:
-    """Compute intermediate representation for form integrals."""
+    """Compute intermediate representation for form integrals.
+
+    If integral_index is given, only the IR of that integral data of the
+    form is computed.
+    """
     _entity_types = {
         "cell": "cell",
         "exterior_facet": "facet",
@@ -251,6 +377,8 @@ def _compute_integral_ir(
     # Iterate over groups of integrals
     irs = []
     for itg_data_index, itg_data in enumerate(form_data.integral_data):
+        if integral_index is not None and itg_data_index != integral_index:
+            continue
         logger.info(f"Computing IR for integral in integral group {itg_data_index}")
         expression_ir = {}
 
@@ -296,7 +424,12 @@ def _compute_integral_ir(
         grouped_integrands: dict[
             basix.CellType, dict[QuadratureRule, list[ufl.core.expr.Expr]]
         ] = {}
-        use_sum_factorization = options["sum_factorization"] and itg_data.integral_type == "cell"
+        use_sum_factorization = options["sum_factorization"] and itg_data.integral_type in (
+            "cell",
+            "exterior_facet",
+            "interior_facet",
+        )
+        rule_degrees: dict[QuadratureRule, int] = {}
         for integral in itg_data.integrals:
             md = integral.metadata() or {}
             scheme = md["quadrature_rule"]
@@ -333,6 +466,18 @@ def _compute_integral_ir(
                 rules[cell_type] = (points, weights, None)
             else:
                 degree = md["quadrature_degree"]
+                budget = options["quadrature_degree_budget"]
+                if md.get("estimated_quadrature_degree", False) and 0 <= budget < degree:
+                    if options["cap_quadrature_degree"]:
+                        warnings.warn(
+                            f"Estimated quadrature degree {degree} exceeds the budget "
+                            f"{budget}, using degree {budget}."
+                        )
+                        degree = budget
+                    else:
+                        warnings.warn(
+                            f"Estimated quadrature degree {degree} exceeds the budget {budget}."
+                        )
                 points, weights, tensor_factors = create_quadrature_points_and_weights(
                     integral_type,
                     ufl_cell,
@@ -355,6 +500,8 @@ def _compute_integral_ir(
                 weights = np.asarray(weights)
                 rule = QuadratureRule(points, weights, tensor_factors)
 
+                if scheme not in ("custom", "vertex"):
+                    rule_degrees[rule] = degree
                 if cell_type not in grouped_integrands:
                     grouped_integrands[cell_type] = {}
                 if rule not in grouped_integrands:
@@ -398,6 +545,17 @@ def _compute_integral_ir(
         # Copy offsets also into IR
         expression_ir["coefficient_offsets"] = offsets
 
+        # Sizes of the per-entity coefficient and geometry arguments, used
+        # as strides by the batched kernels
+        ir["coefficient_size"] = _offset
+        coordinate_element = itg_data.domain.ufl_coordinate_element()
+        num_coordinate_dofs = coordinate_element.dim // coordinate_element.block_size
+        ir["coordinate_dofs_size"] = width * num_coordinate_dofs * 3
+        geometry_shape = _geometry_shape(itg_data.domain, options)
+        # J, detJ and K of each restriction
+        ir["geometry_size"] = 2 * geometry_shape[0] * geometry_shape[1] + 1 if geometry_shape else 0
+        ir["fused_integral"] = None
+
         # Build offsets for Constants
         original_constant_offsets = {}
         _offset = 0
@@ -414,26 +572,129 @@ def _compute_integral_ir(
         }
 
         # Build more specific intermediate representation
-        integral_ir = compute_integral_ir(
-            itg_data.domain.ufl_cell(),
-            itg_data.integral_type,
-            expression_ir["entity_type"],
-            integrand_map,
-            expression_ir["tensor_shape"],
-            options,
-            visualise,
-        )
+        with profiling.scope(integral_names[(form_index, itg_data_index)]):
+            integral_ir = compute_integral_ir(
+                itg_data.domain.ufl_cell(),
+                itg_data.integral_type,
+                expression_ir["entity_type"],
+                integrand_map,
+                expression_ir["tensor_shape"],
+                options,
+                visualise,
+            )
+            _report_cost(integral_ir, rule_degrees)
 
         expression_ir.update(integral_ir)
 
         # Fetch name
         expression_ir["name"] = integral_names[(form_index, itg_data_index)]
         ir["expression"] = CommonExpressionIR(**expression_ir)
+
+        ir["action"] = None
+        ir["action_coefficient"] = None
+        if options["action_kernels"] and form_data.rank == 2:
+            action_coefficient, action_integrands = _action_integrands(integrand_map)
+            with profiling.scope(f"{expression_ir['name']}_action"):
+                action_ir = compute_integral_ir(
+                    itg_data.domain.ufl_cell(),
+                    itg_data.integral_type,
+                    expression_ir["entity_type"],
+                    action_integrands,
+                    expression_ir["tensor_shape"][:1],
+                    options,
+                    visualise,
+                )
+            # The coefficient x is passed separately from the coefficients w
+            action_expression_ir = {
+                **expression_ir,
+                **action_ir,
+                "tensor_shape": expression_ir["tensor_shape"][:1],
+                "coefficient_numbering": {
+                    **coefficient_numbering,
+                    action_coefficient: len(coefficient_numbering),
+                },
+                "coefficient_offsets": {**offsets, action_coefficient: 0},
+            }
+            ir["action"] = CommonExpressionIR(**action_expression_ir)
+            ir["action_coefficient"] = action_coefficient
+
         irs.append(IntegralIR(**ir))
 
     return irs
 
 
+def _geometry_shape(domain: ufl.AbstractDomain, options) -> tuple[int, ...]:
+    """Shape (gdim, tdim) of the precomputed geometry of a cell.
+
+    The geometry is the Jacobian of the map from the reference cell, with
+    its determinant and inverse, which are constant over a cell only for
+    affine simplex meshes. For other meshes, or if the geometry kernels
+    are not requested, the shape is empty.
+    """
+    if not options["geometry_kernels"] or not domain.is_piecewise_linear_simplex_domain():
+        return ()
+    return (domain.geometric_dimension(), domain.topological_dimension())
+
+
+def _estimate_flops(integrand, num_points: int) -> int:
+    """Estimate the floating point operations of an integrand on one entity.
+
+    Every node of the argument factorisation is counted as one operation
+    per quadrature point, and every block as a multiply-add for each
+    entry of the element tensor block it updates, once per point unless
+    all its factors are piecewise.
+    """
+    flops = len(integrand["factorization"].nodes) * num_points
+    for contributions in integrand["block_contributions"].values():
+        for blockdata in contributions:
+            block_size = int(np.prod([mad.tabledata.values.shape[-1] for mad in blockdata.ma_data]))
+            repeats = 1 if blockdata.all_factors_piecewise else num_points
+            flops += 2 * block_size * repeats
+    return flops
+
+
+def _report_cost(integral_ir, rule_degrees: dict[QuadratureRule, int]) -> None:
+    """Log and record the estimated cost of each quadrature rule of an integral."""
+    for (domain, rule), integrand in integral_ir["integrand"].items():
+        num_points = rule.weights.shape[0]
+        flops = _estimate_flops(integrand, num_points)
+        table_size = sum(t.size for t in integral_ir["unique_tables"][domain].values())
+        degree = rule_degrees.get(rule)
+        logger.info(
+            f"Quadrature rule on {domain.name}: degree {degree}, {num_points} points, "
+            f"{table_size} table values, estimated {flops} flops"
+        )
+        profiling.record("quadrature_points", num_points)
+        profiling.record("table_values", table_size)
+        profiling.record("estimated_flops", flops)
+
+
+def _action_integrands(integrand_map):
+    """Replace the trial function of bilinear form integrands by a coefficient.
+
+    Returns:
+        The coefficient and the integrands of the action.
+    """
+    trial_functions = set(
+        v
+        for integrands in integrand_map.values()
+        for integrand in integrands.values()
+        for v in extract_arguments(integrand)
+        if v.number() == 1
+    )
+    assert len(trial_functions) == 1
+    (u,) = trial_functions
+    coefficient = ufl.Coefficient(u.ufl_function_space())
+    action_integrands = {
+        cell_type: {
+            rule: replace(integrand, {u: coefficient})
+            for rule, integrand in integrands.items()
+        }
+        for cell_type, integrands in integrand_map.items()
+    }
+    return coefficient, action_integrands
+
+
 def _compute_form_ir(
     form_data,
     form_id,
@@ -442,6 +703,7 @@ def _compute_form_ir(
     integral_names,
     integral_domains,
     object_names,
+    options,
 ) -> FormIR:
     """Compute intermediate representation of form."""
     logger.info(f"Computing IR for form {form_id}")
@@ -501,6 +763,11 @@ def _compute_form_ir(
             ir["integral_names"][integral_type] += [iname]
             ir["integral_domains"][integral_type] += [integral_domains[iname]]
 
+    ir["has_action_kernels"] = options["action_kernels"] and ir["rank"] == 2
+    # The geometry is shared by the integrals only if they are over a single mesh
+    domains = {itg_data.domain for itg_data in form_data.integral_data}
+    ir["geometry_shape"] = _geometry_shape(domains.pop(), options) if len(domains) == 1 else ()
+
     return FormIR(**ir)
 
 
@@ -591,6 +858,7 @@ def _compute_expression_ir(
 
     # Copy offsets also into IR
     base_ir["coefficient_offsets"] = offsets
+    ir["coefficient_size"] = _offset
 
     base_ir["integral_type"] = "expression"
     if cell is not None:
@@ -620,6 +888,10 @@ def _compute_expression_ir(
     base_ir["coordinate_element_hash"] = (
         expr_domain.ufl_coordinate_element().basix_hash() if expr_domain is not None else 0
     )
+    ir["coordinate_dofs_size"] = 0
+    if expr_domain is not None:
+        coordinate_element = expr_domain.ufl_coordinate_element()
+        ir["coordinate_dofs_size"] = 3 * (coordinate_element.dim // coordinate_element.block_size)
 
     weights = np.array([1.0] * points.shape[0])
     rule = QuadratureRule(points, weights)
@@ -631,15 +903,16 @@ def _compute_expression_ir(
             and len(base_ir["original_constant_offsets"]) == 0
         )
 
-    expression_ir = compute_integral_ir(
-        cell,
-        base_ir["integral_type"],
-        base_ir["entity_type"],
-        integrands,
-        tensor_shape,
-        options,
-        visualise,
-    )
+    with profiling.scope(base_ir["name"]):
+        expression_ir = compute_integral_ir(
+            cell,
+            base_ir["integral_type"],
+            base_ir["entity_type"],
+            integrands,
+            tensor_shape,
+            options,
+            visualise,
+        )
 
     base_ir.update(expression_ir)
     ir["expression"] = CommonExpressionIR(**base_ir)
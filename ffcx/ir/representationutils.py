@@ -49,43 +49,53 @@ class QuadratureRule:
         return self.hash_obj.hexdigest()[-3:]
 
 
+def _tensor_product_rule(factors):
+    """Points and weights of the tensor product of interval rules, last factor fastest."""
+    pts = np.array([tuple(i[0] for i in p) for p in itertools.product(*[f[0] for f in factors])])
+    wts = np.array([np.prod(p) for p in itertools.product(*[f[1] for f in factors])])
+    return pts, wts
+
+
 def create_quadrature_points_and_weights(
     integral_type, cell, degree, rule, elements, use_tensor_product=False
 ):
-    """Create quadrature rule and return points and weights."""
+    """Create quadrature rule and return points and weights.
+
+    With ``use_tensor_product``, the rules of quadrilateral and
+    hexahedral cells and of their facets are tensor products of interval
+    rules, and the interval rules are returned as the tensor factors.
+    """
     pts = {}
     wts = {}
     tensor_factors = {}
     if integral_type == "cell":
         cell_name = cell.cellname()
         if cell_name in ["quadrilateral", "hexahedron"] and use_tensor_product:
-            if cell_name == "quadrilateral":
-                tensor_factors[cell_name] = [
-                    create_quadrature("interval", degree, rule, elements) for _ in range(2)
-                ]
-            elif cell_name == "hexahedron":
-                tensor_factors[cell_name] = [
-                    create_quadrature("interval", degree, rule, elements) for _ in range(3)
-                ]
-            pts[cell_name] = np.array(
-                [
-                    tuple(i[0] for i in p)
-                    for p in itertools.product(*[f[0] for f in tensor_factors[cell_name]])
-                ]
-            )
-            wts[cell_name] = np.array(
-                [np.prod(p) for p in itertools.product(*[f[1] for f in tensor_factors[cell_name]])]
-            )
+            tensor_factors[cell_name] = [
+                create_quadrature("interval", degree, rule, elements)
+                for _ in range(cell.topological_dimension())
+            ]
+            pts[cell_name], wts[cell_name] = _tensor_product_rule(tensor_factors[cell_name])
         else:
             pts[cell_name], wts[cell_name] = create_quadrature(cell_name, degree, rule, elements)
     elif integral_type in ufl.measure.facet_integral_types:
         for ft in cell.facet_types():
-            pts[ft.cellname()], wts[ft.cellname()] = create_quadrature(
-                ft.cellname(),
-                degree,
-                rule,
-                elements,
-            )
+            facet_name = ft.cellname()
+            if cell.cellname() in ["quadrilateral", "hexahedron"] and use_tensor_product:
+                tensor_factors[facet_name] = [
+                    create_quadrature("interval", degree, rule, elements)
+                    for _ in range(ft.topological_dimension())
+                ]
+                pts[facet_name], wts[facet_name] = _tensor_product_rule(
+                    tensor_factors[facet_name]
+                )
+            else:
+                pts[facet_name], wts[facet_name] = create_quadrature(
+                    facet_name,
+                    degree,
+                    rule,
+                    elements,
+                )
     elif integral_type in ufl.measure.point_integral_types:
         pts["vertex"], wts["vertex"] = create_quadrature("vertex", degree, rule, elements)
     elif integral_type == "expression":
@@ -9,6 +9,7 @@ Parse command-line arguments and generate code from input UFL form files.
 """
 
 import argparse
+import contextlib
 import cProfile
 import logging
 import pathlib
@@ -20,7 +21,7 @@ from typing import Optional
 import ufl
 
 from ffcx import __version__ as FFCX_VERSION
-from ffcx import compiler, formatting
+from ffcx import compiler, formatting, profiling
 from ffcx.options import FFCX_DEFAULT_OPTIONS, get_options
 
 logger = logging.getLogger("ffcx")
@@ -32,6 +33,16 @@ parser.add_argument("--version", action="version", version=f"%(prog)s (version {
 parser.add_argument("-o", "--output-directory", type=str, default=".", help="output directory")
 parser.add_argument("--visualise", action="store_true", help="visualise the IR graph")
 parser.add_argument("-p", "--profile", action="store_true", help="enable profiling")
+parser.add_argument(
+    "--profile-json",
+    action="store_true",
+    help="write compile-time profile of stages and integrals as JSON",
+)
+parser.add_argument(
+    "--library",
+    type=str,
+    help="also write a CMake project building the generated C code into a library of this name",
+)
 
 # Add all options from FFCx option system
 for opt_name, (arg_type, opt_val, opt_desc, choices) in FFCX_DEFAULT_OPTIONS.items():
@@ -56,6 +67,7 @@ def main(args: Optional[Sequence[str]] = None) -> int:
     options = get_options(priority_options)
 
     # Call parser and compiler for each file
+    prefixes = []
     for filename in xargs.ufl_file:
         file = pathlib.Path(filename)
 
@@ -64,26 +76,44 @@ def main(args: Optional[Sequence[str]] = None) -> int:
         prefix = file.stem
         prefix = re.subn("[^{}]".format(string.ascii_letters + string.digits + "_"), "!", prefix)[0]
         prefix = re.subn("!+", "_", prefix)[0]
+        prefixes.append(prefix)
 
         # Turn on profiling
         if xargs.profile:
             pr = cProfile.Profile()
             pr.enable()
 
-        # Load UFL file
-        ufd = ufl.algorithms.load_ufl_file(filename)
-
-        # Generate code
-        code_h, code_c = compiler.compile_ufl_objects(
-            ufd.forms + ufd.expressions + ufd.elements,
-            options=options,
-            object_names=ufd.object_names,
-            prefix=prefix,
-            visualise=xargs.visualise,
-        )
+        # Collect compile-time profile
+        profile_json = profiling.profile() if xargs.profile_json else contextlib.nullcontext()
+
+        with profile_json as prof:
+            # Load UFL file
+            ufd = ufl.algorithms.load_ufl_file(filename)
+
+            # Generate code
+            code_h, code_c = compiler.compile_ufl_objects(
+                ufd.forms + ufd.expressions + ufd.elements,
+                options=options,
+                object_names=ufd.object_names,
+                prefix=prefix,
+                visualise=xargs.visualise,
+            )
+
+            # Generate device code
+            if options["gpu_backend"] != "none":
+                code_gpu_h, code_gpu = compiler.compile_gpu_code(
+                    ufd.forms,
+                    options=options,
+                    object_names=ufd.object_names,
+                    prefix=prefix,
+                )
 
         # Write to file
         formatting.write_code(code_h, code_c, prefix, xargs.output_directory)
+        if options["gpu_backend"] != "none":
+            formatting.write_gpu_code(
+                code_gpu_h, code_gpu, prefix, xargs.output_directory, str(options["gpu_backend"])
+            )
 
         # Turn off profiling and write status to file
         if xargs.profile:
@@ -91,4 +121,11 @@ def main(args: Optional[Sequence[str]] = None) -> int:
             pfn = f"ffcx_{prefix}.profile"
             pr.dump_stats(pfn)
 
+        if xargs.profile_json:
+            prof.write_json(f"ffcx_{prefix}_profile.json")
+
+    # Ahead-of-time build of the code of all files
+    if xargs.library is not None:
+        formatting.write_cmake_project(xargs.library, prefixes, xargs.output_directory)
+
     return 0
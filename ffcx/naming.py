@@ -78,6 +78,26 @@ def compute_signature(
     return hashlib.sha1(string.encode("utf-8")).hexdigest()
 
 
+def constant_values_signature(
+    ufl_objects: list[ufl.Form] | list[tuple[ufl.core.expr.Expr, npt.NDArray[np.floating]]],
+    constant_values: dict[ufl.Constant, npt.ArrayLike] | None,
+) -> str:
+    """Compute the signature tag of the values of Constants folded into forms.
+
+    Constants are identified by the index of their form and their
+    position in it, which unlike their ids are the same across processes.
+    """
+    if not constant_values:
+        return ""
+    values = []
+    for i, ufl_object in enumerate(ufl_objects):
+        if isinstance(ufl_object, ufl.Form):
+            for j, constant in enumerate(ufl_object.constants()):
+                if constant in constant_values:
+                    values.append((i, j, np.asarray(constant_values[constant]).tolist()))
+    return str(values)
+
+
 def integral_name(
     original_form: ufl.form.Form,
     integral_type: str,
@@ -28,6 +28,139 @@ FFCX_DEFAULT_OPTIONS = {
         ("float32", "float64", "complex64", "complex128"),
     ),
     "sum_factorization": (bool, False, "use sum factorization.", None),
+    "quadrature_degree_budget": (
+        int,
+        -1,
+        "largest estimated quadrature degree of an integral accepted without a warning, -1 for no "
+        "budget. Degrees set in the integral metadata are not checked.",
+        None,
+    ),
+    "cap_quadrature_degree": (
+        bool,
+        False,
+        "use quadrature_degree_budget as the quadrature degree of integrals with a larger "
+        "estimated degree.",
+        None,
+    ),
+    "compute_precision": (
+        str,
+        "default",
+        "precision of the tables, quadrature weights and values at quadrature points of integral "
+        "kernels, and of the tables of expression kernels, default is the precision of "
+        "scalar_type.",
+        ("default", "float32", "float64"),
+    ),
+    "geometry_precision": (
+        str,
+        "default",
+        "precision of the geometry computed by integral kernels, default is the precision of "
+        "scalar_type.",
+        ("default", "float32", "float64"),
+    ),
+    "accumulation_precision": (
+        str,
+        "default",
+        "precision in which integral kernels, including the action and fused kernels, accumulate "
+        "the element tensor before adding it to A, default is the precision of scalar_type.",
+        ("default", "float32", "float64"),
+    ),
+    "cell_batch_size": (
+        int,
+        1,
+        "number of cells W per call of cell-batched (vectorised across cells) kernels, "
+        "1 disables them and the batched expression kernels.",
+        None,
+    ),
+    "batch_block_size": (
+        int,
+        8,
+        "number of cells tabulated together by the batched integral kernels, with the loop over "
+        "the cells of a block innermost, 1 to tabulate the cells one at a time.",
+        None,
+    ),
+    "table_alignment": (
+        int,
+        0,
+        "alignment in bytes of the static tables and local arrays of the kernels, with the "
+        "innermost dimension of the tables padded to a multiple of it, 0 for natural alignment.",
+        (0, 16, 32, 64),
+    ),
+    "simd_hints": (
+        bool,
+        False,
+        "mark the innermost loops of the kernels which have no loop-carried dependencies for "
+        "vectorisation.",
+        None,
+    ),
+    "isa_dispatch": (
+        bool,
+        False,
+        "also compile all kernels of the integrals for SSE4.2, AVX2 and AVX-512 on x86-64 and "
+        "for NEON and SVE on AArch64 Linux with GCC and clang, and select the kernels for the "
+        "CPU in ufcx_integral and ufcx_fused_integral when the code is loaded.",
+        None,
+    ),
+    "action_kernels": (
+        bool,
+        False,
+        "also generate matrix-free tabulate_action kernels for the integrals of bilinear forms.",
+        None,
+    ),
+    "geometry_kernels": (
+        bool,
+        False,
+        "also generate tabulate_tensor_geometry kernels reading the Jacobian, its determinant "
+        "and inverse from precomputed geometry, for integrals over affine simplex meshes.",
+        None,
+    ),
+    "fused_kernels": (
+        bool,
+        False,
+        "also generate fused kernels computing the integrals of all forms over the same entities "
+        "in one pass, sharing the evaluation of geometry and coefficients.",
+        None,
+    ),
+    "gather_kernels": (
+        bool,
+        False,
+        "also generate tabulate_tensor_gather kernels reading the coefficients from their global "
+        "dof arrays through their dofmaps, without packing.",
+        None,
+    ),
+    "scatter_kernels": (
+        bool,
+        False,
+        "also generate tabulate_tensor_scatter kernels adding the element tensor directly into "
+        "global values at given positions, atomically when compiled with OpenMP.",
+        None,
+    ),
+    "permuted_kernels": (
+        bool,
+        False,
+        "also generate interior facet kernels specialised for each pair of quadrature "
+        "permutations, reading the permuted tables at indices fixed at compile time.",
+        None,
+    ),
+    "gpu_backend": (
+        str,
+        "none",
+        "language of the device kernels generated next to the C code, tabulating one entity per "
+        "thread, 'none' for no device kernels.",
+        ("none", "cuda", "hip"),
+    ),
+    "parallel_workers": (
+        int,
+        1,
+        "number of worker processes computing the IR and code of the integrals in parallel, "
+        "0 for the number of CPUs, 1 computes them one after another.",
+        None,
+    ),
+    "kernel_stats": (
+        bool,
+        False,
+        "count calls and clock ticks of tabulate_tensor in ufcx_integral.stats.",
+        None,
+    ),
     "table_rtol": (
         float,
         1e-6,
@@ -0,0 +1,160 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx. (https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Parallel computation of the IR and code of integrals.
+
+Once the UFL objects are analysed, the integrals are independent of each
+other. With the ``parallel_workers`` option, a pool of worker processes
+computes the IR and generates the code of one integral at a time. The
+workers are forked from the compiling process and inherit the analysis,
+so only the generated code is sent back.
+
+Each worker declares the tables of its integral in its own table pool.
+The tables are added to the pool of the module, and renamed in the
+code, in the order of the integrals, so the generated code is the same as when computed
+in one process whatever the number of workers and the order in which
+they finish.
+"""
+
+from __future__ import annotations
+
+import concurrent.futures
+import contextlib
+import multiprocessing
+import os
+import re
+import typing
+import warnings
+
+import basix
+import numpy as np
+import numpy.typing as npt
+
+from ffcx import profiling
+from ffcx.analysis import UFLData
+from ffcx.codegeneration.C.integrals import generator as integral_generator
+from ffcx.codegeneration.codegeneration import integral_domains
+from ffcx.codegeneration.table_pool import TablePool
+from ffcx.ir.representation import compute_integral_data_ir, compute_integral_names
+
+
+class IntegralCode(typing.NamedTuple):
+    """Code of the integrals computed by the workers."""
+
+    # Code blocks (declaration, implementation) of the kernels
+    code: list[tuple[str, str]]
+    # Pool of the tables used by the kernels
+    table_pool: TablePool
+    # Cell types of each integral, by name
+    domains: dict[str, set[basix.CellType]]
+
+
+class _WorkerResult(typing.NamedTuple):
+    """Result of a worker for one integral."""
+
+    name: str
+    domains: list[str]
+    code: list[tuple[str, str]]
+    tables: list[tuple[str, npt.NDArray[np.float64]]]
+    warnings: list[tuple[str, type[Warning]]]
+    profile: typing.Optional[dict[str, dict[str, typing.Any]]]
+
+
+# Names of the tables of a table pool in the generated code
+_table_name = re.compile(r"\bffcx_table_\d+\b")
+
+# State inherited by the forked workers
+_state: typing.Optional[tuple] = None
+
+
+def num_workers(
+    analysis: UFLData, options: dict[str, typing.Union[npt.DTypeLike, int, float]]
+) -> int:
+    """Number of worker processes used for the integrals, 1 if computed in this process.
+
+    Parallel computation needs the fork start method. Fused kernels
+    combine the IR of several integrals and are computed in this
+    process.
+    """
+    workers = options["parallel_workers"]
+    if workers == 0:
+        workers = os.cpu_count() or 1
+    num_integrals = sum(len(fd.integral_data) for fd in analysis.form_data)
+    if (
+        workers < 2
+        or num_integrals < 2
+        or options["fused_kernels"]
+        or "fork" not in multiprocessing.get_all_start_methods()
+    ):
+        return 1
+    return min(workers, num_integrals)
+
+
+def compute_integral_code(
+    analysis: UFLData,
+    prefix: str,
+    options: dict[str, typing.Union[npt.DTypeLike, int, float]],
+    visualise: bool,
+    workers: int,
+) -> IntegralCode:
+    """Compute the IR and code of the integrals in worker processes."""
+    global _state
+    table_rtol, table_atol = options["table_rtol"], options["table_atol"]
+    names = compute_integral_names(analysis, prefix)
+    tasks = list(names.keys())
+
+    _state = (analysis, names, options, visualise, profiling.is_active())
+    try:
+        context = multiprocessing.get_context("fork")
+        with concurrent.futures.ProcessPoolExecutor(workers, mp_context=context) as executor:
+            results = list(executor.map(_integral_code, tasks))
+    finally:
+        _state = None
+
+    table_pool = TablePool(table_rtol, table_atol)
+    code = []
+    domains = {}
+    for result in results:
+        for message, category in result.warnings:
+            warnings.warn(message, category)
+        if result.profile is not None:
+            profiling.merge(result.profile)
+        renamed = {name: table_pool.get(values).name for name, values in result.tables}
+        code += [
+            (_rename_tables(declaration, renamed), _rename_tables(implementation, renamed))
+            for declaration, implementation in result.code
+        ]
+        domains[result.name] = set(getattr(basix.CellType, d) for d in result.domains)
+    return IntegralCode(code, table_pool, domains)
+
+
+def _integral_code(task: tuple[int, int]) -> _WorkerResult:
+    """Compute the IR and code of an integral, in a worker."""
+    assert _state is not None
+    analysis, names, options, visualise, profile = _state
+    form_index, integral_index = task
+    table_pool = TablePool(options["table_rtol"], options["table_atol"])
+    with warnings.catch_warnings(record=True) as caught:
+        warnings.simplefilter("always")
+        with profiling.profile() if profile else contextlib.nullcontext() as prof:
+            ir = compute_integral_data_ir(
+                analysis, form_index, integral_index, names, options, visualise
+            )
+            domains = integral_domains(ir)
+            code = [integral_generator(ir, domain, options, table_pool) for domain in domains]
+
+    return _WorkerResult(
+        name=ir.expression.name,
+        domains=[domain.name for domain in domains],
+        code=code,
+        tables=[(decl.symbol.name, decl.values) for decl in table_pool.declarations],
+        warnings=[(str(w.message), w.category) for w in caught],
+        profile=prof.kernels if prof is not None else None,
+    )
+
+
+def _rename_tables(code: str, names: dict[str, str]) -> str:
+    """Rename the tables of a worker's table pool in code."""
+    return _table_name.sub(lambda m: names[m.group(0)], code)
@@ -0,0 +1,127 @@
+# Copyright (C) 2025 FEniCS Project
+#
+# This file is part of FFCx.(https://www.fenicsproject.org)
+#
+# SPDX-License-Identifier:    LGPL-3.0-or-later
+"""Compile-time profiling.
+
+Collects the time spent in the compiler stages and, for each integral
+and expression, in the main steps of computing its representation and
+code, together with the sizes of the expression graphs and of the
+generated code. Nothing is collected unless a profile is active::
+
+    with ffcx.profiling.profile() as prof:
+        ffcx.codegeneration.jit.compile_forms(forms)
+    prof.write_json("ffcx_profile.json")
+
+Times are accumulated, so an integral with several quadrature rules
+reports the total time of all rules.
+"""
+
+from __future__ import annotations
+
+import contextlib
+import json
+import typing
+from time import perf_counter
+
+
+class Profile:
+    """Compile-time profile."""
+
+    def __init__(self):
+        """Initialise."""
+        # Totals of the compiler stages and of the JIT C compiler
+        self.stages: dict[str, float] = {}
+        # Timers and counters of each integral and expression, by name
+        self.kernels: dict[str, dict[str, typing.Any]] = {}
+        self._scope: typing.Optional[str] = None
+
+    def add(self, key: str, value: float, scope: typing.Optional[str] = None) -> None:
+        """Accumulate a value in a kernel scope, or in the stages if no scope."""
+        if scope is None:
+            self.stages[key] = self.stages.get(key, 0) + value
+        else:
+            data = self.kernels.setdefault(scope, {})
+            data[key] = data.get(key, 0) + value
+
+    def to_dict(self) -> dict[str, typing.Any]:
+        """Profile as a dictionary of plain data."""
+        return {"stages": dict(self.stages), "kernels": {k: dict(v) for k, v in self.kernels.items()}}
+
+    def write_json(self, filename) -> None:
+        """Write the profile to a JSON file."""
+        with open(filename, "w") as f:
+            json.dump(self.to_dict(), f, indent=2, sort_keys=True)
+
+
+_active: typing.Optional[Profile] = None
+
+
+@contextlib.contextmanager
+def profile():
+    """Collect a profile of the compilations in the context."""
+    global _active
+    previous = _active
+    _active = Profile()
+    try:
+        yield _active
+    finally:
+        _active = previous
+
+
+@contextlib.contextmanager
+def scope(name: str):
+    """Attribute the timers and counters in the context to a kernel."""
+    if _active is None:
+        yield
+        return
+    previous = _active._scope
+    _active._scope = name
+    try:
+        yield
+    finally:
+        _active._scope = previous
+
+
+@contextlib.contextmanager
+def timer(key: str, stage: bool = False):
+    """Time the context.
+
+    Args:
+        key: Name of the timer.
+        stage: Accumulate in the stage totals instead of the current
+            kernel scope.
+    """
+    if _active is None:
+        yield
+        return
+    prof = _active
+    key_scope = None if stage else prof._scope
+    t0 = perf_counter()
+    try:
+        yield
+    finally:
+        prof.add(key, perf_counter() - t0, key_scope)
+
+
+def record(key: str, value: int) -> None:
+    """Accumulate a counter in the current kernel scope."""
+    if _active is not None:
+        _active.add(key, value, _active._scope)
+
+
+def is_active() -> bool:
+    """Check if a profile is collected."""
+    return _active is not None
+
+
+def merge(kernels: dict[str, dict[str, typing.Any]]) -> None:
+    """Accumulate the kernel timers and counters of a profile collected elsewhere.
+
+    Used for the profiles collected by worker processes.
+    """
+    if _active is not None:
+        for name, data in kernels.items():
+            for key, value in data.items():
+                _active.add(key, value, name)
@@ -10,6 +10,7 @@ import basix.ufl
 import ufl
 
 import ffcx.codegeneration.jit
+from ffcx.codegeneration.cache import ModuleCache
 
 
 def test_cache_modes(compile_args):
@@ -39,3 +40,121 @@ def test_cache_modes(compile_args):
 
     assert newname == tmpname
     assert newfile != tmpfile
+
+
+def test_split_units(compile_args, tmp_path):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    m = ufl.inner(u, v) * ufl.dx
+
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a, m], cache_dir=tmp_path, cffi_extra_compile_args=compile_args, split_units=True
+    )
+    assert [f.rank for f in compiled_forms] == [2, 2]
+    objects = {f: f.stat().st_mtime_ns for f in tmp_path.glob("libffcx_unit_*.o")}
+    assert len(objects) == 2
+
+    # Changing one form only compiles a new unit for that form
+    L = ufl.inner(1.0, v) * ufl.dx
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a, L], cache_dir=tmp_path, cffi_extra_compile_args=compile_args, split_units=True
+    )
+    assert [f.rank for f in compiled_forms] == [2, 1]
+    new_objects = {f: f.stat().st_mtime_ns for f in tmp_path.glob("libffcx_unit_*.o")}
+    assert len(new_objects) == 3
+    assert all(new_objects[f] == t for f, t in objects.items())
+
+
+def test_cache_eviction(compile_args, tmp_path):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    m = ufl.inner(u, v) * ufl.dx
+
+    _, module_a, _ = ffcx.codegeneration.jit.compile_forms(
+        [a], cache_dir=tmp_path, cffi_extra_compile_args=compile_args
+    )
+    size = sum(f.stat().st_size for f in tmp_path.glob(module_a.__name__ + ".*"))
+    assert size > 0
+
+    # Cache hit, without generating code
+    _, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a], cache_dir=tmp_path, cffi_extra_compile_args=compile_args
+    )
+    assert module.__name__ == module_a.__name__
+    assert code == (None, None)
+
+    # Least recently used module is evicted
+    _, module_m, _ = ffcx.codegeneration.jit.compile_forms(
+        [m],
+        cache_dir=tmp_path,
+        cffi_extra_compile_args=compile_args,
+        cache_size_limit=int(1.5 * size),
+    )
+    assert len(list(tmp_path.glob(module_a.__name__ + ".*"))) == 0
+    assert len(list(tmp_path.glob(module_m.__name__ + ".*"))) > 0
+
+    # Only the index and lock files of the remaining module are kept
+    assert len(list(tmp_path.glob("*.index"))) == 1
+    assert len(list(tmp_path.glob("*.lock"))) == 1
+
+
+def test_cache_eviction_units(compile_args, tmp_path):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    m = ufl.inner(u, v) * ufl.dx
+
+    _, module_am, _ = ffcx.codegeneration.jit.compile_forms(
+        [a, m], cache_dir=tmp_path, cffi_extra_compile_args=compile_args, split_units=True
+    )
+    units = set(tmp_path.glob("libffcx_unit_*"))
+    assert len([f for f in units if f.suffix == ".o"]) == 2
+    size = sum(
+        f.stat().st_size
+        for f in tmp_path.glob("libffcx_*")
+        if f.suffix not in (".index", ".lock", ".units")
+    )
+
+    # Units linked into a cached module are kept, but count towards the size
+    ModuleCache(tmp_path, size_limit=size - 1).evict()
+    assert len(list(tmp_path.glob(module_am.__name__ + ".*"))) == 0
+    assert set(tmp_path.glob("libffcx_unit_*")) == units
+    assert len(list(tmp_path.glob("*.units"))) == 0
+
+    # Units of evicted modules are evicted as least recently used
+    _, module_m, _ = ffcx.codegeneration.jit.compile_forms(
+        [m], cache_dir=tmp_path, cffi_extra_compile_args=compile_args
+    )
+    size = sum(f.stat().st_size for f in tmp_path.glob(module_m.__name__ + ".*"))
+    ModuleCache(tmp_path, size_limit=size).evict()
+    assert len(list(tmp_path.glob("libffcx_unit_*"))) == 0
+    assert len(list(tmp_path.glob(module_m.__name__ + ".*"))) > 0
+
+
+def test_process_cache(compile_args, tmp_path):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+
+    _, module_a, _ = ffcx.codegeneration.jit.compile_forms(
+        [a], cache_dir=tmp_path, cffi_extra_compile_args=compile_args
+    )
+
+    # Same module object, even when the cache directory is cleared
+    for f in tmp_path.iterdir():
+        f.unlink()
+    _, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a], cache_dir=tmp_path, cffi_extra_compile_args=compile_args
+    )
+    assert module is module_a
+    assert code == (None, None)
@@ -4,6 +4,7 @@
 #
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 
+import json
 import os
 import os.path
 import subprocess
@@ -16,6 +17,31 @@ def test_cmdline_simple():
     subprocess.run(["ffcx", "Poisson.py"])
 
 
+def test_profile_json():
+    os.chdir(os.path.dirname(__file__))
+    subprocess.run(["ffcx", "--profile-json", "Poisson.py"], check=True)
+    with open("ffcx_Poisson_profile.json") as f:
+        profile = json.load(f)
+    assert set(profile["stages"]) == {"analysis", "compute_ir", "generate_code", "format_code"}
+    assert len(profile["kernels"]) > 0
+    for kernel in profile["kernels"].values():
+        assert kernel["build_optimized_tables"] >= 0
+        assert kernel["factorization_nodes"] > 0
+        assert kernel["code_size"] > 0
+
+
+def test_library(tmp_path):
+    os.chdir(os.path.dirname(__file__))
+    subprocess.run(
+        ["ffcx", "--isa_dispatch", "--library", "forms", "-o", str(tmp_path), "Poisson.py"],
+        check=True,
+    )
+    assert (tmp_path / "Poisson.c").exists()
+    project = (tmp_path / "CMakeLists.txt").read_text()
+    assert "add_library(forms Poisson.c)" in project
+    assert "ufcx::ufcx" in project
+
+
 def test_visualise():
     try:
         import pygraphviz  # noqa: F401
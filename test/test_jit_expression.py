@@ -482,3 +482,68 @@ def test_coordinate_free_expression(compile_args):
     # Check that the expression evaluates to [1, 0] at all points
     expected = np.array([[1.0, 0.0], [1.0, 0.0], [1.0, 0.0]])
     assert np.allclose(A, expected)
+
+
+def test_batch_expression(compile_args):
+    """Test that the batched kernel matches the single cell kernel on each cell."""
+    e = basix.ufl.element("P", "triangle", 1, shape=(2,))
+    mesh = ufl.Mesh(e)
+    V = ufl.FunctionSpace(mesh, e)
+    f = ufl.Coefficient(V)
+    expr = ufl.Constant(mesh) * ufl.grad(f[0]) + f
+
+    points = np.array([[0.0, 0.0], [1.0, 0.0], [0.0, 1.0], [1 / 3, 1 / 3]])
+    ffi = cffi.FFI()
+
+    # Batched kernels are only generated with cell batching
+    obj, module, code = ffcx.codegeneration.jit.compile_expressions(
+        [(expr, points)], cffi_extra_compile_args=compile_args
+    )
+    assert obj[0].tabulate_tensor_batch_float64 == ffi.NULL
+
+    obj, module, code = ffcx.codegeneration.jit.compile_expressions(
+        [(expr, points)], options={"cell_batch_size": 4}, cffi_extra_compile_args=compile_args
+    )
+    expression = obj[0]
+    assert expression.tabulate_tensor_batch_float32 == ffi.NULL
+
+    dtype = np.float64
+    c_type = "double"
+    num_cells = 5
+    rng = np.random.default_rng(0)
+
+    # Output layout A[cell][point][component]
+    A = np.zeros((num_cells, points.shape[0], 2), dtype=dtype)
+    w = rng.random((num_cells, 6)).astype(dtype)
+    c = np.array([0.5], dtype=dtype)
+    coords = np.zeros((num_cells, 3, 3), dtype=dtype)
+    coords[:, :, :2] = np.array([[0.0, 0.0], [1.0, 0.0], [0.0, 1.0]])
+    coords[:, :, :2] += 0.2 * rng.random((num_cells, 3, 2))
+    entity_index = np.zeros(num_cells, dtype=np.intc)
+    quad_perm = np.zeros(num_cells, dtype=np.uint8)
+
+    expression.tabulate_tensor_batch_float64(
+        ffi.cast(f"{c_type} *", A.ctypes.data),
+        ffi.cast(f"{c_type} *", w.ctypes.data),
+        ffi.cast(f"{c_type} *", c.ctypes.data),
+        ffi.cast(f"{c_type} *", coords.ctypes.data),
+        ffi.cast("int *", entity_index.ctypes.data),
+        ffi.cast("uint8_t *", quad_perm.ctypes.data),
+        num_cells,
+        ffi.NULL,
+    )
+
+    for cell in range(num_cells):
+        A_cell = np.zeros((points.shape[0], 2), dtype=dtype)
+        w_cell = w[cell].copy()
+        coords_cell = coords[cell].copy()
+        expression.tabulate_tensor_float64(
+            ffi.cast(f"{c_type} *", A_cell.ctypes.data),
+            ffi.cast(f"{c_type} *", w_cell.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_type} *", coords_cell.ctypes.data),
+            ffi.cast("int *", entity_index.ctypes.data),
+            ffi.cast("uint8_t *", quad_perm.ctypes.data),
+            ffi.NULL,
+        )
+        assert np.allclose(A[cell], A_cell)
@@ -4,6 +4,10 @@
 #
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 
+import itertools
+import re
+import shutil
+import subprocess
 import sys
 
 import basix.ufl
@@ -14,6 +18,9 @@ import ufl
 from sympy.abc import x, y, z
 
 import ffcx.codegeneration.jit
+import ffcx.compiler
+import ffcx.options
+import ffcx.profiling
 from ffcx.codegeneration.utils import dtype_to_c_type, dtype_to_scalar_dtype
 
 
@@ -1404,3 +1411,1125 @@ def test_ds_prism(compile_args, dtype):
             ]
         ),
     )
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+@pytest.mark.parametrize("block_size", [1, 4])
+def test_batched_kernel(compile_args, dtype, block_size):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    g = ufl.Coefficient(space)
+    a = g * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.ds
+    forms = [a]
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms,
+        options={"scalar_type": dtype, "batch_block_size": block_size},
+        cffi_extra_compile_args=compile_args,
+    )
+    blocked = "for (int cell = 0; cell < block_cells; ++cell)" in code[1]
+    assert blocked == (block_size > 1)
+
+    ffi = module.ffi
+    form0 = compiled_forms[0]
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+
+    # Not a multiple of the block size, to tabulate a partial block
+    num_cells = 11
+    rng = np.random.default_rng(0)
+    ref_coords = np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0]])
+    coords = np.array(
+        [ref_coords + 0.1 * rng.random((3, 3)) for _ in range(num_cells)], dtype=xdtype
+    )
+    coords[:, :, 2] = 0.0
+    w = rng.random((num_cells, 6)).astype(dtype)
+    c = np.array([], dtype=dtype)
+    entity_index = rng.integers(0, 3, num_cells).astype(np.intc)
+
+    for integral_type in ("cell", "exterior_facet"):
+        offsets = form0.form_integral_offsets
+        integral = form0.form_integrals[offsets[getattr(module.lib, integral_type)]]
+        kernel = getattr(integral, f"tabulate_tensor_{dtype}")
+        batch_kernel = getattr(integral, f"tabulate_tensor_batch_{dtype}")
+        entities = ffi.NULL
+        if integral_type == "exterior_facet":
+            entities = ffi.cast("int *", entity_index.ctypes.data)
+
+        A_batch = np.zeros((num_cells, 6, 6), dtype=dtype)
+        batch_kernel(
+            ffi.cast(f"{c_type} *", A_batch.ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+            entities,
+            ffi.NULL,
+            num_cells,
+            ffi.NULL,
+        )
+
+        for cell in range(num_cells):
+            A = np.zeros((6, 6), dtype=dtype)
+            if integral_type == "exterior_facet":
+                entities = ffi.cast("int *", entity_index[cell:].ctypes.data)
+            kernel(
+                ffi.cast(f"{c_type} *", A.ctypes.data),
+                ffi.cast(f"{c_type} *", w[cell].ctypes.data),
+                ffi.cast(f"{c_type} *", c.ctypes.data),
+                ffi.cast(f"{c_xtype} *", coords[cell].ctypes.data),
+                entities,
+                ffi.NULL,
+                ffi.NULL,
+            )
+            assert np.allclose(A_batch[cell], A)
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+def test_cell_batched_kernel(compile_args, dtype):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    g = ufl.Coefficient(space)
+    a = (1 + g**2) * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    forms = [a]
+    W = 4
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms,
+        options={"scalar_type": dtype, "cell_batch_size": W},
+        cffi_extra_compile_args=compile_args,
+    )
+
+    ffi = module.ffi
+    integral = compiled_forms[0].form_integrals[0]
+    assert integral.cell_batch_size == W
+    kernel = getattr(integral, f"tabulate_tensor_{dtype}")
+    batch_kernel = getattr(integral, f"tabulate_tensor_cell_batch_{dtype}")
+    assert batch_kernel != ffi.NULL
+
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+    rng = np.random.default_rng(0)
+    ref_coords = np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0]])
+    coords = np.array([ref_coords + 0.1 * rng.random((3, 3)) for _ in range(W)], dtype=xdtype)
+    w = rng.random((W, 3)).astype(dtype)
+    c = np.array([], dtype=dtype)
+
+    # Structure-of-arrays layout, with the cell index running fastest
+    A_batch = np.zeros((3, 3, W), dtype=dtype)
+    w_batch = np.ascontiguousarray(w.T)
+    coords_batch = np.ascontiguousarray(np.moveaxis(coords, 0, -1))
+    batch_kernel(
+        ffi.cast(f"{c_type} *", A_batch.ctypes.data),
+        ffi.cast(f"{c_type} *", w_batch.ctypes.data),
+        ffi.cast(f"{c_type} *", c.ctypes.data),
+        ffi.cast(f"{c_xtype} *", coords_batch.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    for cell in range(W):
+        A = np.zeros((3, 3), dtype=dtype)
+        kernel(
+            ffi.cast(f"{c_type} *", A.ctypes.data),
+            ffi.cast(f"{c_type} *", w[cell].ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", coords[cell].ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+        assert np.allclose(A_batch[:, :, cell], A, rtol=1e-5)
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+def test_kernel_stats(compile_args, dtype):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(u, v) * ufl.dx
+    kappa = ufl.Constant(domain, shape=(2, 2))
+    a_kappa = ufl.inner(kappa * ufl.grad(u), ufl.grad(v)) * ufl.dx
+    forms = [a, a_kappa]
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms,
+        options={"scalar_type": dtype, "kernel_stats": True},
+        cffi_extra_compile_args=compile_args,
+    )
+
+    ffi = module.ffi
+    form0 = compiled_forms[0]
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+
+    integral = form0.form_integrals[0]
+    assert integral.flops_per_call > 0
+    assert integral.bytes_per_call == 18 * np.dtype(dtype).itemsize + 9 * np.dtype(xdtype).itemsize
+
+    # Constants are shared by all entities and not counted per call
+    assert compiled_forms[1].form_integrals[0].bytes_per_call == integral.bytes_per_call
+    assert integral.stats.num_calls == 0
+
+    # Clock advancing by 10 ticks on each read
+    ticks = iter(range(0, 1000, 10))
+    clock = ffi.callback("uint64_t(void)", lambda: next(ticks))
+    integral.stats.clock = clock
+
+    num_cells = 3
+    A = np.zeros((num_cells, 3, 3), dtype=dtype)
+    w = np.array([], dtype=dtype)
+    c = np.array([], dtype=dtype)
+    coords = np.tile(
+        np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0]], dtype=xdtype), (num_cells, 1)
+    )
+    batch_kernel = getattr(integral, f"tabulate_tensor_batch_{dtype}")
+    batch_kernel(
+        ffi.cast(f"{c_type} *", A.ctypes.data),
+        ffi.cast(f"{c_type} *", w.ctypes.data),
+        ffi.cast(f"{c_type} *", c.ctypes.data),
+        ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        num_cells,
+        ffi.NULL,
+    )
+    assert integral.stats.num_calls == num_cells
+    assert integral.stats.ticks == 10 * num_cells
+
+
+@pytest.mark.parametrize("dtype", ["float64", "complex128"])
+def test_action_kernel(compile_args, dtype):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    kappa = ufl.Coefficient(ufl.FunctionSpace(domain, basix.ufl.element("Lagrange", "triangle", 1)))
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = kappa * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx
+    forms = [a]
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms,
+        options={"scalar_type": dtype, "action_kernels": True},
+        cffi_extra_compile_args=compile_args,
+    )
+
+    ffi = module.ffi
+    form0 = compiled_forms[0]
+    assert form0.has_action_kernels
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+
+    integral = form0.form_integrals[0]
+    kernel = getattr(integral, f"tabulate_tensor_{dtype}")
+    action = getattr(integral, f"tabulate_action_{dtype}")
+    assert action != ffi.NULL
+
+    rng = np.random.default_rng(0)
+    A = np.zeros((6, 6), dtype=dtype)
+    x = rng.random(6).astype(dtype)
+    y = np.zeros(6, dtype=dtype)
+    w = rng.random(3).astype(dtype)
+    c = np.array([], dtype=dtype)
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]], dtype=xdtype)
+    kernel(
+        ffi.cast(f"{c_type} *", A.ctypes.data),
+        ffi.cast(f"{c_type} *", w.ctypes.data),
+        ffi.cast(f"{c_type} *", c.ctypes.data),
+        ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+    action(
+        ffi.cast(f"{c_type} *", y.ctypes.data),
+        ffi.cast(f"{c_type} *", x.ctypes.data),
+        ffi.cast(f"{c_type} *", w.ctypes.data),
+        ffi.cast(f"{c_type} *", c.ctypes.data),
+        ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+    np.testing.assert_allclose(y, A @ x, rtol=1e-12, atol=1e-12)
+
+    # Not generated by default
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms, options={"scalar_type": dtype}, cffi_extra_compile_args=compile_args
+    )
+    assert not compiled_forms[0].has_action_kernels
+    action = getattr(compiled_forms[0].form_integrals[0], f"tabulate_action_{dtype}")
+    assert action == module.ffi.NULL
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64", "complex128"])
+def test_geometry_kernel(compile_args, dtype):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    kappa = ufl.Coefficient(ufl.FunctionSpace(domain, basix.ufl.element("Lagrange", "triangle", 1)))
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = kappa * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.ds
+    forms = [a]
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms,
+        options={"scalar_type": dtype, "geometry_kernels": True},
+        cffi_extra_compile_args=compile_args,
+    )
+
+    ffi = module.ffi
+    form0 = compiled_forms[0]
+    assert form0.geometry_size == 9
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]], dtype=xdtype)
+    geometry = np.zeros(form0.geometry_size, dtype=xdtype)
+    tabulate_geometry = getattr(form0, f"tabulate_geometry_{xdtype}")
+    tabulate_geometry(
+        ffi.cast(f"{c_xtype} *", geometry.ctypes.data),
+        ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+    )
+    # J, detJ and K
+    np.testing.assert_allclose(geometry, [2.0, 0.5, 0.0, 1.0, 2.0, 0.5, -0.25, 0.0, 1.0])
+
+    # detJ and K are read from the geometry, not recomputed from the vertices
+    kernels = code[1].split("void tabulate_tensor_geometry_")[1:]
+    assert len(kernels) == 2
+    for kernel in kernels:
+        body = kernel.split("\n}\n")[0]
+        assert "coordinate_dofs[" not in body
+    assert any("geometry[4]" in kernel and "geometry[5]" in kernel for kernel in kernels)
+
+    rng = np.random.default_rng(0)
+    w = rng.random(3).astype(dtype)
+    c = np.array([], dtype=dtype)
+    entity_local_index = np.array([1], dtype=np.intc)
+    tol = 1e-5 if xdtype == np.float32 else 1e-12
+    for integral in form0.form_integrals[0 : form0.form_integral_offsets[2]]:
+        kernel = getattr(integral, f"tabulate_tensor_{dtype}")
+        geometry_kernel = getattr(integral, f"tabulate_tensor_geometry_{dtype}")
+        assert geometry_kernel != ffi.NULL
+        A = np.zeros((6, 6), dtype=dtype)
+        B = np.zeros((6, 6), dtype=dtype)
+        kernel(
+            ffi.cast(f"{c_type} *", A.ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+            ffi.cast("int *", entity_local_index.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+        )
+        geometry_kernel(
+            ffi.cast(f"{c_type} *", B.ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+            ffi.cast(f"{c_xtype} *", geometry.ctypes.data),
+            ffi.cast("int *", entity_local_index.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+        )
+        np.testing.assert_allclose(B, A, rtol=tol, atol=tol)
+
+    # Not generated by default
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms, options={"scalar_type": dtype}, cffi_extra_compile_args=compile_args
+    )
+    assert compiled_forms[0].geometry_size == 0
+    assert getattr(compiled_forms[0], f"tabulate_geometry_{xdtype}") == module.ffi.NULL
+    integral = compiled_forms[0].form_integrals[0]
+    assert getattr(integral, f"tabulate_tensor_geometry_{dtype}") == module.ffi.NULL
+
+
+@pytest.mark.parametrize("dtype", ["float64", "complex128"])
+def test_fused_kernels(compile_args, dtype):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, f = ufl.Coefficient(space), ufl.Coefficient(space)
+    v = ufl.TestFunction(space)
+    F = (1 + u**2) * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx - ufl.inner(f, v) * ufl.dx
+    J = ufl.derivative(F, u, ufl.TrialFunction(space))
+    forms = [F, J]
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms,
+        options={"scalar_type": dtype, "fused_kernels": True},
+        cffi_extra_compile_args=compile_args,
+    )
+
+    ffi = module.ffi
+    assert compiled_forms[0].num_coefficients == 2
+    assert compiled_forms[1].num_coefficients == 1
+    integral_F = compiled_forms[0].form_integrals[0]
+    integral_J = compiled_forms[1].form_integrals[0]
+    fused = integral_F.fused
+    assert fused != ffi.NULL
+    assert integral_J.fused == fused
+    assert fused.num_integrals == 2
+    assert fused.integrals[0] == integral_F
+    assert fused.integrals[1] == integral_J
+
+    # Coefficient u and the geometry are evaluated once
+    assert fused.flops_per_call < integral_F.flops_per_call + integral_J.flops_per_call
+
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+    rng = np.random.default_rng(0)
+    w_u, w_f = rng.random(3), rng.random(3)
+    w_F = np.concatenate([w_u, w_f]).astype(dtype)
+    w_J = w_u.astype(dtype)
+    c = np.array([], dtype=dtype)
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]], dtype=xdtype)
+
+    b_ref = np.zeros(3, dtype=dtype)
+    A_ref = np.zeros((3, 3), dtype=dtype)
+    for integral, tensor, w in ((integral_F, b_ref, w_F), (integral_J, A_ref, w_J)):
+        getattr(integral, f"tabulate_tensor_{dtype}")(
+            ffi.cast(f"{c_type} *", tensor.ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+
+    b = np.zeros(3, dtype=dtype)
+    A = np.zeros((3, 3), dtype=dtype)
+
+    def pointers(*arrays):
+        data = [ffi.cast(f"{c_type} *", a.ctypes.data) for a in arrays]
+        return ffi.new(f"{c_type}*[{len(arrays)}]", data)
+
+    getattr(fused, f"tabulate_tensor_{dtype}")(
+        pointers(b, A),
+        pointers(w_F, w_J),
+        pointers(c, c),
+        ffi.cast(f"{c_xtype} *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+    np.testing.assert_allclose(b, b_ref, rtol=1e-12, atol=1e-12)
+    np.testing.assert_allclose(A, A_ref, rtol=1e-12, atol=1e-12)
+
+    # Not generated by default
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        forms, options={"scalar_type": dtype}, cffi_extra_compile_args=compile_args
+    )
+    assert compiled_forms[0].form_integrals[0].fused == module.ffi.NULL
+
+
+def test_mixed_precision(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx
+
+    # Stretched cell
+    coords = np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.5, 1e-3, 0.0]])
+
+    def tabulate(options):
+        compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+            [a], options=options, cffi_extra_compile_args=compile_args
+        )
+        dtype = np.dtype(options["scalar_type"])
+        c_type = dtype_to_c_type(dtype)
+        ffi = module.ffi
+        A = np.zeros((6, 6), dtype=dtype)
+        x = coords.astype(dtype)
+        c = np.array([], dtype=dtype)
+        getattr(compiled_forms[0].form_integrals[0], f"tabulate_tensor_{dtype}")(
+            ffi.cast(f"{c_type} *", A.ctypes.data),
+            ffi.NULL,
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_type} *", x.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+        return A, code[1]
+
+    A_ref, _ = tabulate({"scalar_type": "float64"})
+    tol = 1e-5 * np.abs(A_ref).max()
+
+    # float32 interface and arithmetic, float64 geometry and accumulation
+    A, code = tabulate(
+        {
+            "scalar_type": "float32",
+            "geometry_precision": "float64",
+            "accumulation_precision": "float64",
+        }
+    )
+    assert "double A_acc[36]" in code
+    np.testing.assert_allclose(A, A_ref, atol=tol)
+
+    # The action and fused kernels accumulate in the same precision
+    options = {
+        "scalar_type": "float32",
+        "geometry_precision": "float64",
+        "accumulation_precision": "float64",
+        "action_kernels": True,
+        "fused_kernels": True,
+    }
+    L = ufl.inner(1.0, v) * ufl.dx
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a, L], options=options, cffi_extra_compile_args=compile_args
+    )
+    assert "double y_acc[6]" in code[1]
+    assert "double A_0_acc[36]" in code[1]
+    assert "double A_1_acc[6]" in code[1]
+    ffi = module.ffi
+    x = np.arange(6, dtype=np.float32)
+    y = np.zeros(6, dtype=np.float32)
+    c = np.array([], dtype=np.float32)
+    coords32 = coords.astype(np.float32)
+    compiled_forms[0].form_integrals[0].tabulate_action_float32(
+        ffi.cast("float *", y.ctypes.data),
+        ffi.cast("float *", x.ctypes.data),
+        ffi.NULL,
+        ffi.cast("float *", c.ctypes.data),
+        ffi.cast("float *", coords32.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+    np.testing.assert_allclose(y, A_ref @ x, atol=10 * tol)
+
+    # float32 tables and arithmetic for a float64 interface
+    A, code = tabulate({"scalar_type": "float64", "compute_precision": "float32"})
+    assert "static const float ffcx_table_" in code
+    assert "static const double ffcx_table_" not in code
+    np.testing.assert_allclose(A, A_ref, atol=tol)
+
+    # Tables declared in the kernels, as those of expressions, follow the
+    # compute precision and not the geometry precision
+    options = ffcx.options.get_options(
+        {"scalar_type": "float64", "compute_precision": "float32", "geometry_precision": "float64"}
+    )
+    points = np.array([[0.25, 0.25], [0.5, 0.25]])
+    _, code_c = ffcx.compiler.compile_ufl_objects(
+        [(ufl.grad(ufl.Coefficient(space)), points)], options=options
+    )
+    assert "static const float FE" in code_c
+    assert "static const double FE" not in code_c
+
+
+def test_table_pool():
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    options = ffcx.options.get_options()
+
+    def num_tables(form):
+        _, code_c = ffcx.compiler.compile_ufl_objects([form], options=options)
+        return code_c.count("static const"), code_c.count("ffcx_table_")
+
+    # Integrals over different subdomains share the tables of one integral
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx(1)
+    declarations, references = num_tables(a)
+    a2 = a + 2.0 * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx(2)
+    declarations2, references2 = num_tables(a2)
+    assert declarations2 == declarations
+    assert references2 > references
+
+
+def test_compressed_tables(compile_args):
+    # Each reference component of RTCF is zero for the dofs of the facets parallel
+    # to it, so the component tables are stored without these dofs
+    element = basix.ufl.element("RTCF", "quadrilateral", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "quadrilateral", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    f = ufl.Coefficient(space)
+    a = ufl.inner(u, v) * ufl.dx
+    L = ufl.inner(f, v) * ufl.dx
+
+    _, code_c = ffcx.compiler.compile_ufl_objects([a], options=ffcx.options.get_options())
+    assert "DM0" in code_c
+
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a, L], cffi_extra_compile_args=compile_args
+    )
+    ffi = module.ffi
+    dim = element.dim
+    coords = np.array(
+        [[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [1.0, 1.0, 0.0]], dtype=np.float64
+    )
+    c = np.array([], dtype=np.float64)
+    w = np.random.default_rng(0).random(dim)
+
+    A = np.zeros((dim, dim), dtype=np.float64)
+    kernel = getattr(compiled_forms[0].form_integrals[0], "tabulate_tensor_float64")
+    kernel(
+        ffi.cast("double *", A.ctypes.data),
+        ffi.NULL,
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    b = np.zeros(dim, dtype=np.float64)
+    kernel = getattr(compiled_forms[1].form_integrals[0], "tabulate_tensor_float64")
+    kernel(
+        ffi.cast("double *", b.ctypes.data),
+        ffi.cast("double *", w.ctypes.data),
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    # On the reference cell the Piola map is the identity
+    points, weights = basix.make_quadrature(basix.CellType.quadrilateral, 8)
+    phi = element.tabulate(0, points)[0].reshape(len(weights), 2, dim)
+    A_ref = np.einsum("q,qci,qcj->ij", weights, phi, phi)
+    np.testing.assert_allclose(A, A_ref, rtol=1e-12, atol=1e-12)
+    np.testing.assert_allclose(b, A_ref @ w, rtol=1e-12, atol=1e-12)
+
+
+def test_quadrature_invariant_arguments(compile_args):
+    # The gradients of P1 are constant, so the coefficient is integrated
+    # in the quadrature loop and the gradients are applied after it
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    coefficient_element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    kappa = ufl.Coefficient(ufl.FunctionSpace(domain, coefficient_element))
+    g = ufl.Coefficient(space)
+    a = kappa * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    L = kappa * ufl.inner(ufl.grad(g), ufl.grad(v)) * ufl.dx
+
+    _, code_c = ffcx.compiler.compile_ufl_objects([a, L], options=ffcx.options.get_options())
+    assert "fq0" in code_c
+
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a, L], cffi_extra_compile_args=compile_args
+    )
+    ffi = module.ffi
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]], dtype=np.float64)
+    c = np.array([], dtype=np.float64)
+    rng = np.random.default_rng(0)
+    w_kappa = rng.random(coefficient_element.dim)
+    w_g = rng.random(element.dim)
+
+    A = np.zeros((3, 3), dtype=np.float64)
+    kernel = getattr(compiled_forms[0].form_integrals[0], "tabulate_tensor_float64")
+    kernel(
+        ffi.cast("double *", A.ctypes.data),
+        ffi.cast("double *", w_kappa.ctypes.data),
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    b = np.zeros(3, dtype=np.float64)
+    w = np.concatenate([w_kappa, w_g])
+    kernel = getattr(compiled_forms[1].form_integrals[0], "tabulate_tensor_float64")
+    kernel(
+        ffi.cast("double *", b.ctypes.data),
+        ffi.cast("double *", w.ctypes.data),
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    # Integral of kappa over the cell, and physical gradients of the P1 basis
+    points, weights = basix.make_quadrature(basix.CellType.triangle, 4)
+    J = (coords[1:, :2] - coords[0, :2]).T
+    detJ = abs(np.linalg.det(J))
+    kappa_integral = detJ * weights @ coefficient_element.tabulate(0, points)[0] @ w_kappa
+    G = np.array([[-1.0, -1.0], [1.0, 0.0], [0.0, 1.0]]) @ np.linalg.inv(J)
+    A_ref = kappa_integral * G @ G.T
+    np.testing.assert_allclose(A, A_ref, rtol=1e-12, atol=1e-12)
+    np.testing.assert_allclose(b, A_ref @ w_g, rtol=1e-12, atol=1e-12)
+
+
+def test_symmetric_tensor(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    b = ufl.as_vector((1.0, 2.0))
+    a = (ufl.inner(ufl.grad(u), ufl.grad(v)) + ufl.inner(u, v)) * ufl.dx
+    a_advection = ufl.inner(ufl.dot(b, ufl.grad(u)), v) * ufl.dx
+
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a, a_advection], cffi_extra_compile_args=compile_args
+    )
+    assert compiled_forms[0].form_integrals[0].symmetric
+    assert not compiled_forms[1].form_integrals[0].symmetric
+
+    ffi = module.ffi
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]], dtype=np.float64)
+    c = np.array([], dtype=np.float64)
+    A = np.zeros((element.dim, element.dim), dtype=np.float64)
+    kernel = getattr(compiled_forms[0].form_integrals[0], "tabulate_tensor_float64")
+    kernel(
+        ffi.cast("double *", A.ctypes.data),
+        ffi.NULL,
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    points, weights = basix.make_quadrature(basix.CellType.triangle, 4)
+    phi = element.tabulate(1, points)
+    J = (coords[1:, :2] - coords[0, :2]).T
+    detJ = abs(np.linalg.det(J))
+    grad_phi = np.einsum("kqi,kl->qil", phi[1:], np.linalg.inv(J))
+    A_ref = detJ * (
+        np.einsum("q,qik,qjk->ij", weights, grad_phi, grad_phi)
+        + np.einsum("q,qi,qj->ij", weights, phi[0], phi[0])
+    )
+    np.testing.assert_allclose(A, A_ref, rtol=1e-12, atol=1e-12)
+
+
+def test_permuted_kernels(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.jump(u), ufl.jump(v)) * ufl.dS
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a], options={"permuted_kernels": True}, cffi_extra_compile_args=compile_args
+    )
+
+    ffi = module.ffi
+    integral = compiled_forms[0].form_integrals[0]
+    num_permutations = integral.num_quadrature_permutations
+    assert num_permutations == 2
+    assert integral.tabulate_tensor_permuted_float32 == ffi.NULL
+
+    w = np.array([], dtype=np.float64)
+    c = np.array([], dtype=np.float64)
+    facets = np.array([0, 2], dtype=np.intc)
+    coords = np.array(
+        [
+            [0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0],
+            [1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0],
+        ],
+        dtype=np.float64,
+    )
+    for perm0, perm1 in itertools.product(range(num_permutations), repeat=2):
+        perms = np.array([perm0, perm1], dtype=np.uint8)
+        A = np.zeros((12, 12), dtype=np.float64)
+        B = np.zeros((12, 12), dtype=np.float64)
+        integral.tabulate_tensor_float64(
+            ffi.cast("double *", A.ctypes.data),
+            ffi.cast("double *", w.ctypes.data),
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.cast("int *", facets.ctypes.data),
+            ffi.cast("uint8_t *", perms.ctypes.data),
+            ffi.NULL,
+        )
+        kernel = integral.tabulate_tensor_permuted_float64[perm0 * num_permutations + perm1]
+        kernel(
+            ffi.cast("double *", B.ctypes.data),
+            ffi.cast("double *", w.ctypes.data),
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.cast("int *", facets.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+        )
+        np.testing.assert_allclose(B, A)
+
+    # Not generated by default
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a], cffi_extra_compile_args=compile_args
+    )
+    integral = compiled_forms[0].form_integrals[0]
+    assert integral.num_quadrature_permutations == 0
+    assert integral.tabulate_tensor_permuted_float64 == module.ffi.NULL
+
+
+def test_constant_values(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    kappa = ufl.Constant(domain)
+    beta = ufl.Constant(domain, shape=(2,))
+    a = kappa * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    a += ufl.inner(ufl.dot(beta, ufl.grad(u)), v) * ufl.dx
+
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]])
+    c = np.array([2.0, 0.0, 0.0])
+
+    def tabulate(constant_values):
+        compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+            [a], constant_values=constant_values, cffi_extra_compile_args=compile_args
+        )
+        ffi = module.ffi
+        form = compiled_forms[0]
+        assert form.num_constants == 2
+        A = np.zeros((6, 6))
+        integral = form.form_integrals[0]
+        integral.tabulate_tensor_float64(
+            ffi.cast("double *", A.ctypes.data),
+            ffi.NULL,
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+        return A, integral.flops_per_call
+
+    A_ref, flops_ref = tabulate(None)
+    A, flops = tabulate({kappa: 2.0, beta: [0.0, 0.0]})
+    np.testing.assert_allclose(A, A_ref)
+    assert flops < flops_ref
+
+    with pytest.raises(ValueError):
+        tabulate({beta: 1.0})
+
+
+def test_gather_kernel(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    kappa = ufl.Coefficient(ufl.FunctionSpace(domain, basix.ufl.element("Lagrange", "triangle", 1)))
+    b = ufl.Coefficient(
+        ufl.FunctionSpace(domain, basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    )
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = kappa * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    a += ufl.inner(ufl.dot(b, ufl.grad(u)), v) * ufl.dx
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a], options={"gather_kernels": True}, cffi_extra_compile_args=compile_args
+    )
+
+    ffi = module.ffi
+    integral = compiled_forms[0].form_integrals[0]
+    assert integral.tabulate_tensor_gather_float32 == ffi.NULL
+
+    # Global dof arrays and the dofmaps of the cell
+    rng = np.random.default_rng(0)
+    kappa_global = rng.random(10)
+    b_global = rng.random(2 * 8)
+    kappa_dofmap = np.array([3, 7, 1], dtype=np.int32)
+    b_dofmap = np.array([5, 0, 2], dtype=np.int32)
+
+    # Packed coefficients, in the order of the coefficients of the form
+    packed = {
+        kappa: kappa_global[kappa_dofmap],
+        b: b_global[(2 * b_dofmap[:, None] + np.arange(2)).flatten()],
+    }
+    w = np.concatenate([packed[f] for f in a.coefficients()])
+    w_global = {kappa: kappa_global, b: b_global}
+    dofmaps = {kappa: kappa_dofmap, b: b_dofmap}
+
+    c = np.array([], dtype=np.float64)
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]])
+    A = np.zeros((6, 6))
+    integral.tabulate_tensor_float64(
+        ffi.cast("double *", A.ctypes.data),
+        ffi.cast("double *", w.ctypes.data),
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+
+    B = np.zeros((6, 6))
+    w_pointers = ffi.new(
+        "double*[]", [ffi.cast("double *", w_global[f].ctypes.data) for f in a.coefficients()]
+    )
+    dofmap_pointers = ffi.new(
+        "int32_t*[]", [ffi.cast("int32_t *", dofmaps[f].ctypes.data) for f in a.coefficients()]
+    )
+    integral.tabulate_tensor_gather_float64(
+        ffi.cast("double *", B.ctypes.data),
+        w_pointers,
+        dofmap_pointers,
+        ffi.cast("double *", c.ctypes.data),
+        ffi.cast("double *", coords.ctypes.data),
+        ffi.NULL,
+        ffi.NULL,
+        ffi.NULL,
+    )
+    np.testing.assert_allclose(B, A)
+
+
+def test_quadrature_degree_budget(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    f = ufl.Coefficient(space)
+    a = f * f * u * v * ufl.dx
+
+    def compile(options):
+        with ffcx.profiling.profile() as prof:
+            compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+                [a], options=options, cffi_extra_compile_args=compile_args
+            )
+        kernels = [k for k in prof.kernels.values() if "estimated_flops" in k]
+        assert len(kernels) == 1
+        return compiled_forms[0].form_integrals[0], kernels[0]
+
+    integral_ref, profile_ref = compile({})
+    with pytest.warns(UserWarning, match="exceeds the budget"):
+        compile({"quadrature_degree_budget": 4})
+    with pytest.warns(UserWarning, match="using degree 4"):
+        integral, profile = compile({"quadrature_degree_budget": 4, "cap_quadrature_degree": True})
+
+    assert profile["quadrature_points"] < profile_ref["quadrature_points"]
+    assert profile["estimated_flops"] < profile_ref["estimated_flops"]
+    assert integral.flops_per_call < integral_ref.flops_per_call
+
+
+def test_aligned_tables(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]])
+
+    def tabulate(options):
+        compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+            [a], options=options, cffi_extra_compile_args=compile_args
+        )
+        ffi = module.ffi
+        A = np.zeros((6, 6))
+        c = np.array([], dtype=np.float64)
+        compiled_forms[0].form_integrals[0].tabulate_tensor_float64(
+            ffi.cast("double *", A.ctypes.data),
+            ffi.NULL,
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+        return A, code[1]
+
+    A_ref, _ = tabulate({})
+    A, code = tabulate({"table_alignment": 64, "simd_hints": True})
+    np.testing.assert_allclose(A, A_ref)
+
+    # Tables of the six P2 basis functions are padded to eight doubles
+    assert "static const alignas(64) double ffcx_table_" in code
+    assert "[8] = {" in code
+    assert "FFCX_SIMD\n" in code
+
+
+def test_isa_dispatch(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    coords = np.array([[0.0, 0.0, 0.0], [2.0, 0.0, 0.0], [0.5, 1.0, 0.0]] * 2)
+    c = np.array([], dtype=np.float64)
+
+    def tabulate(options):
+        compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+            [a], options=options, cffi_extra_compile_args=compile_args
+        )
+        ffi = module.ffi
+        A = np.zeros((2, 6, 6))
+        compiled_forms[0].form_integrals[0].tabulate_tensor_batch_float64(
+            ffi.cast("double *", A.ctypes.data),
+            ffi.NULL,
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            2,
+            ffi.NULL,
+        )
+        return A, code[1]
+
+    A_ref, _ = tabulate({})
+    A, code = tabulate({"isa_dispatch": True, "action_kernels": True, "gather_kernels": True})
+    np.testing.assert_allclose(A, A_ref)
+    assert '__attribute__((target("avx2,fma")))' in code
+    assert '__builtin_cpu_supports("avx2")' in code
+    assert '__attribute__((target("arch=armv8-a+simd")))' in code
+    assert "(hwcap & HWCAP_SVE)" in code
+
+    # All kernels of the integral are dispatched
+    for field in ("tabulate_tensor", "tabulate_tensor_batch", "tabulate_action"):
+        assert re.search(rf"\.{field}_float64 = {field}_\w+_avx2;", code)
+    assert re.search(r"\.tabulate_tensor_gather_float64 = tabulate_tensor_gather_\w+_avx2;", code)
+    assert re.search(r"\.tabulate_tensor_float64 = tabulate_tensor_\w+_neon;", code)
+
+
+def test_scatter_kernels(compile_args):
+    element = basix.ufl.element("Lagrange", "triangle", 1)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [a], options={"scatter_kernels": True}, cffi_extra_compile_args=compile_args
+    )
+    ffi = module.ffi
+    integral = compiled_forms[0].form_integrals[0]
+    assert "FFCX_ATOMIC\n" in code[1]
+
+    # Two cells of a square sharing the edge between vertices 1 and 2
+    x = np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [1.0, 1.0, 0.0]])
+    cells = [[0, 1, 2], [1, 3, 2]]
+    c = np.array([], dtype=np.float64)
+
+    A_ref = np.zeros((4, 4))
+    values = np.zeros(16)
+    for dofs in cells:
+        coords = x[dofs].copy()
+        A = np.zeros((3, 3))
+        integral.tabulate_tensor_float64(
+            ffi.cast("double *", A.ctypes.data),
+            ffi.NULL,
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+        A_ref[np.ix_(dofs, dofs)] += A
+
+        # Positions of the entries in the row-major dense matrix
+        positions = np.array([4 * i + j for i in dofs for j in dofs], dtype=np.int64)
+        integral.tabulate_tensor_scatter_float64(
+            ffi.cast("double *", values.ctypes.data),
+            ffi.cast("int64_t *", positions.ctypes.data),
+            ffi.NULL,
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+
+    np.testing.assert_allclose(values.reshape(4, 4), A_ref)
+
+
+def test_parallel_workers():
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    f = ufl.Coefficient(space)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx(1) + f * ufl.inner(u, v) * ufl.dx(2)
+    a += ufl.inner(u, v) * ufl.ds
+    L = f * v * ufl.dx + f * v * ufl.ds
+
+    def generate(workers):
+        options = ffcx.options.get_options({"parallel_workers": workers})
+        _, code_c = ffcx.compiler.compile_ufl_objects([a, L], options=options)
+        # Drop the comments, which list the options
+        return [line for line in code_c.splitlines() if not line.startswith("//")]
+
+    # The code, including the names of the shared tables, does not depend
+    # on the number of workers
+    code = generate(1)
+    assert generate(3) == code
+    assert generate(0) == code
+
+
+def test_gpu_code(tmp_path):
+    element = basix.ufl.element("Lagrange", "triangle", 2)
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "triangle", 1, shape=(2,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.TrialFunction(space), ufl.TestFunction(space)
+    f = ufl.Coefficient(space)
+    a = f * ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.ds
+    options = ffcx.options.get_options({"gpu_backend": "cuda"})
+    code_h, code_gpu = ffcx.compiler.compile_gpu_code([a], options=options, prefix="gpu")
+    code_c = ffcx.compiler.compile_ufl_objects([a], options=options, prefix="gpu")[1]
+
+    # One device kernel for each integral of the C code
+    integrals = set(re.findall(r"^ufcx_integral (\w+) =", code_c, re.MULTILINE))
+    assert integrals
+    assert set(re.findall(r"^extern ufcx_gpu_integral (\w+)_gpu;", code_h, re.MULTILINE)) == (
+        integrals
+    )
+    assert code_gpu.count("extern \"C\" __global__ void") == len(integrals)
+    assert "static __constant__ const double ffcx_table_" in code_gpu
+
+    # Compile as host C++, with the CUDA keywords and thread indices
+    # defined by a shim
+    if shutil.which("g++") is None:
+        return
+    (tmp_path / "shim.h").write_text(
+        "#define __global__\n#define __constant__\n#define __device__\n"
+        "static const struct { unsigned x; } blockIdx = {0}, blockDim = {1}, threadIdx = {0};\n"
+    )
+    (tmp_path / "gpu.cu").write_text(code_gpu)
+    subprocess.run(
+        ["g++", "-x", "c++", "-fsyntax-only", "-Wall", "-Werror", "-include", "shim.h"]
+        + ["-I", ffcx.codegeneration.get_include_path(), "gpu.cu"],
+        cwd=tmp_path,
+        check=True,
+    )
+
+
+def test_hyperelasticity_jacobian(compile_args):
+    # Tensor-valued constitutive law with many scalar subexpressions
+    element = basix.ufl.element("Lagrange", "tetrahedron", 2, shape=(3,))
+    domain = ufl.Mesh(basix.ufl.element("Lagrange", "tetrahedron", 1, shape=(3,)))
+    space = ufl.FunctionSpace(domain, element)
+    u, v = ufl.Coefficient(space), ufl.TestFunction(space)
+    F = ufl.Identity(3) + ufl.grad(u)
+    C = F.T * F
+    J = ufl.det(F)
+    mu, lmbda = 1.0, 10.0
+    psi = mu / 2 * (ufl.tr(C) - 3) - mu * ufl.ln(J) + lmbda / 2 * ufl.ln(J) ** 2
+    L = ufl.derivative(psi * ufl.dx, u, v)
+    a = ufl.derivative(L, u, ufl.TrialFunction(space))
+    compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+        [L, a], cffi_extra_compile_args=compile_args
+    )
+    ffi = module.ffi
+
+    c = np.array([], dtype=np.float64)
+    coords = np.array(
+        [[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [0.0, 0.0, 1.0]], dtype=np.float64
+    )
+
+    def tabulate(form, shape, w):
+        A = np.zeros(shape)
+        compiled_forms[form].form_integrals[0].tabulate_tensor_float64(
+            ffi.cast("double *", A.ctypes.data),
+            ffi.cast("double *", w.ctypes.data),
+            ffi.cast("double *", c.ctypes.data),
+            ffi.cast("double *", coords.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+        return A
+
+    # The Jacobian matches central differences of the residual
+    rng = np.random.default_rng(0)
+    w = 0.05 * rng.random(30)
+    A = tabulate(1, (30, 30), w)
+    eps = 1e-6
+    A_fd = np.zeros((30, 30))
+    for j in range(30):
+        dw = np.zeros(30)
+        dw[j] = eps
+        A_fd[:, j] = (tabulate(0, (30,), w + dw) - tabulate(0, (30,), w - dw)) / (2 * eps)
+    np.testing.assert_allclose(A, A_fd, atol=1e-6 * np.abs(A).max())
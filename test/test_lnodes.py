@@ -6,6 +6,7 @@ from cffi import FFI
 
 from ffcx.codegeneration import lnodes as L
 from ffcx.codegeneration.C.c_implementation import CFormatter
+from ffcx.codegeneration.optimizer import optimize_kernel
 from ffcx.codegeneration.utils import dtype_to_c_type
 
 
@@ -102,3 +103,47 @@ def test_gemv(dtype):
 
     gemv(py, pA, px)
     assert np.all(y == result)
+
+
+def test_optimize_kernel():
+    # Inverse of a 2x2 matrix J with repeated products, divisions by the
+    # determinant, an integer power and a constant factor
+    J = L.Symbol("J", dtype=L.DataType.REAL)
+    K = L.Symbol("K", dtype=L.DataType.SCALAR)
+    sp = [L.Symbol(f"sp_{i}", dtype=L.DataType.SCALAR) for i in range(9)]
+    code = [
+        L.VariableDecl(sp[0], J[0] * J[3]),
+        L.VariableDecl(sp[1], J[3] * J[0]),
+        L.VariableDecl(sp[2], sp[1] - J[1] * J[2]),
+        L.VariableDecl(sp[3], J[3] / sp[2]),
+        L.VariableDecl(sp[4], L.Neg(J[1]) / sp[2]),
+        L.VariableDecl(sp[5], L.Neg(J[2]) / sp[2]),
+        L.VariableDecl(sp[6], J[0] / sp[2]),
+        L.VariableDecl(sp[7], L.Mul(L.LiteralFloat(2.0), L.LiteralFloat(0.5))),
+        L.VariableDecl(sp[8], L.MathFunction("power", [sp[0], L.LiteralInt(2)])),
+        L.Assign(K[0], sp[7] * sp[3]),
+        L.Assign(K[1], sp[4]),
+        L.Assign(K[2], sp[5]),
+        L.Assign(K[3], sp[6]),
+        L.Assign(K[4], sp[8]),
+    ]
+
+    Q = CFormatter(dtype="float64")
+    optimized = Q.c_format(L.StatementList(optimize_kernel(code)))
+    assert optimized.count("/") == 1
+    assert "pow" not in optimized
+    assert "sp_1" not in optimized and "sp_7" not in optimized
+
+    decl = "void inverse(double *K, const double *J)"
+    ffibuilder = FFI()
+    ffibuilder.cdef(decl + ";")
+    ffibuilder.set_source("_optimize_kernel", decl + "{\n" + optimized + "\n}\n")
+    ffibuilder.compile(verbose=True)
+    _inverse = importlib.import_module("_optimize_kernel")
+    ffi = _inverse.ffi
+
+    Jv = np.array([2.0, 1.0, 0.5, 3.0])
+    Kv = np.zeros(5)
+    _inverse.lib.inverse(ffi.cast("double *", Kv.ctypes.data), ffi.cast("double *", Jv.ctypes.data))
+    np.testing.assert_allclose(Kv[:4], np.linalg.inv(Jv.reshape(2, 2)).flatten(), rtol=1e-14)
+    assert Kv[4] == (Jv[0] * Jv[3]) ** 2
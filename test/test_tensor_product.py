@@ -130,3 +130,205 @@ def test_bilinear_form(dtype, P, cell_type):
     )
 
     np.testing.assert_allclose(A, A1, rtol=1e-6, atol=1e-6)
+
+
+def reference_coordinates(cell_type, xdtype, shift=0.0):
+    """Vertex coordinates of the reference cell, shifted in x."""
+    if cell_type == basix.CellType.quadrilateral:
+        coords = [[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [1.0, 1.0, 0.0]]
+    else:
+        coords = [
+            [0.0, 0.0, 0.0],
+            [1.0, 0.0, 0.0],
+            [0.0, 1.0, 0.0],
+            [1.0, 1.0, 0.0],
+            [0.0, 0.0, 1.0],
+            [1.0, 0.0, 1.0],
+            [0.0, 1.0, 1.0],
+            [1.0, 1.0, 1.0],
+        ]
+    coords = np.array(coords, dtype=xdtype)
+    coords[:, 0] += shift
+    return coords
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+@pytest.mark.parametrize("P", [1, 2, 3])
+@pytest.mark.parametrize("cell_type", [basix.CellType.quadrilateral, basix.CellType.hexahedron])
+@pytest.mark.parametrize("integral_type", ["exterior_facet", "interior_facet"])
+def test_facet_bilinear_form(dtype, P, cell_type, integral_type):
+    gdim = cell_to_gdim(cell_type)
+    element = create_tensor_product_element(cell_type, P, basix.LagrangeVariant.gll_warped)
+    coords = create_tensor_product_element(
+        cell_type, 1, basix.LagrangeVariant.gll_warped, shape=(gdim,)
+    )
+    mesh = ufl.Mesh(coords)
+    V = ufl.FunctionSpace(mesh, element)
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    if integral_type == "exterior_facet":
+        a = (ufl.inner(u, v) + ufl.inner(ufl.grad(u), ufl.grad(v))) * ufl.ds
+        ndofs = element.dim
+    else:
+        a = (
+            ufl.inner(ufl.jump(ufl.grad(u)), ufl.jump(ufl.grad(v)))
+            + ufl.inner(ufl.avg(u), ufl.avg(v))
+        ) * ufl.dS
+        ndofs = 2 * element.dim
+
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+    w = np.array([], dtype=dtype)
+    c = np.array([], dtype=dtype)
+    if integral_type == "exterior_facet":
+        x = reference_coordinates(cell_type, xdtype)
+        facets = np.array([1], dtype=np.intc)
+        perms = np.array([0], dtype=np.uint8)
+    else:
+        # Two cells sharing the facet x = 1, with arbitrary permutations
+        x = np.vstack(
+            [reference_coordinates(cell_type, xdtype), reference_coordinates(cell_type, xdtype, 1)]
+        )
+        facets = np.array([2, 1] if gdim == 2 else [3, 2], dtype=np.intc)
+        perms = np.array([1, 0] if gdim == 2 else [3, 6], dtype=np.uint8)
+
+    A = {}
+    for sf in (False, True):
+        compiled_forms, module, _ = ffcx.codegeneration.jit.compile_forms(
+            [a], options={"scalar_type": dtype, "sum_factorization": sf}
+        )
+        form0 = compiled_forms[0]
+        offsets = form0.form_integral_offsets
+        itype = getattr(module.lib, integral_type)
+        assert offsets[itype + 1] - offsets[itype] == 1
+        kernel = getattr(form0.form_integrals[offsets[itype]], f"tabulate_tensor_{dtype}")
+        ffi = module.ffi
+        A[sf] = np.zeros((ndofs, ndofs), dtype=dtype)
+        kernel(
+            ffi.cast(f"{c_type} *", A[sf].ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", x.ctypes.data),
+            ffi.cast("int *", facets.ctypes.data),
+            ffi.cast("uint8_t *", perms.ctypes.data),
+            ffi.NULL,
+        )
+
+    np.testing.assert_allclose(A[False], A[True], rtol=1e-5, atol=1e-5)
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+@pytest.mark.parametrize("P", [1, 2, 3])
+@pytest.mark.parametrize("cell_type", [basix.CellType.quadrilateral, basix.CellType.hexahedron])
+@pytest.mark.parametrize("integral_type", ["exterior_facet", "interior_facet"])
+def test_facet_linear_form_action(dtype, P, cell_type, integral_type):
+    gdim = cell_to_gdim(cell_type)
+    element = create_tensor_product_element(cell_type, P, basix.LagrangeVariant.gll_warped)
+    coords = create_tensor_product_element(
+        cell_type, 1, basix.LagrangeVariant.gll_warped, shape=(gdim,)
+    )
+    mesh = ufl.Mesh(coords)
+    V = ufl.FunctionSpace(mesh, element)
+    f, v = ufl.Coefficient(V), ufl.TestFunction(V)
+    if integral_type == "exterior_facet":
+        L = (ufl.inner(f, v) + ufl.inner(ufl.grad(f), ufl.grad(v))) * ufl.ds
+        ndofs = element.dim
+    else:
+        L = (
+            ufl.inner(ufl.jump(ufl.grad(f)), ufl.jump(ufl.grad(v)))
+            + ufl.inner(ufl.avg(f), ufl.avg(v))
+        ) * ufl.dS
+        ndofs = 2 * element.dim
+
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+    w = np.random.default_rng(0).random(ndofs).astype(dtype)
+    c = np.array([], dtype=dtype)
+    if integral_type == "exterior_facet":
+        x = reference_coordinates(cell_type, xdtype)
+        facets = np.array([1], dtype=np.intc)
+        perms = np.array([0], dtype=np.uint8)
+    else:
+        x = np.vstack(
+            [reference_coordinates(cell_type, xdtype), reference_coordinates(cell_type, xdtype, 1)]
+        )
+        facets = np.array([2, 1] if gdim == 2 else [3, 2], dtype=np.intc)
+        perms = np.array([1, 0] if gdim == 2 else [3, 6], dtype=np.uint8)
+
+    b = {}
+    for sf in (False, True):
+        compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+            [L], options={"scalar_type": dtype, "sum_factorization": sf}
+        )
+        # The coefficient and the test function are contracted in stages
+        # with the factor tables of each facet
+        assert ("FE_TF" in code[1]) == sf
+        form0 = compiled_forms[0]
+        offsets = form0.form_integral_offsets
+        itype = getattr(module.lib, integral_type)
+        assert offsets[itype + 1] - offsets[itype] == 1
+        kernel = getattr(form0.form_integrals[offsets[itype]], f"tabulate_tensor_{dtype}")
+        ffi = module.ffi
+        b[sf] = np.zeros(ndofs, dtype=dtype)
+        kernel(
+            ffi.cast(f"{c_type} *", b[sf].ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", x.ctypes.data),
+            ffi.cast("int *", facets.ctypes.data),
+            ffi.cast("uint8_t *", perms.ctypes.data),
+            ffi.NULL,
+        )
+
+    np.testing.assert_allclose(b[False], b[True], rtol=1e-5, atol=1e-5)
+
+
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+@pytest.mark.parametrize("P", [1, 2, 3])
+@pytest.mark.parametrize("cell_type", [basix.CellType.quadrilateral, basix.CellType.hexahedron])
+@pytest.mark.parametrize("blocked", [False, True])
+def test_linear_form_action(dtype, P, cell_type, blocked):
+    gdim = cell_to_gdim(cell_type)
+    shape = (gdim,) if blocked else None
+    element = create_tensor_product_element(cell_type, P, basix.LagrangeVariant.gll_warped, shape)
+    coords = create_tensor_product_element(
+        cell_type, 1, basix.LagrangeVariant.gll_warped, shape=(gdim,)
+    )
+    mesh = ufl.Mesh(coords)
+    V = ufl.FunctionSpace(mesh, element)
+    f, v = ufl.Coefficient(V), ufl.TestFunction(V)
+    L = (ufl.inner(ufl.grad(f), ufl.grad(v)) + ufl.inner(f, v)) * ufl.dx
+
+    ndofs = element.dim
+    xdtype = dtype_to_scalar_dtype(dtype)
+    c_type, c_xtype = dtype_to_c_type(dtype), dtype_to_c_type(xdtype)
+    w = np.random.default_rng(0).random(ndofs).astype(dtype)
+    c = np.array([], dtype=dtype)
+    x = reference_coordinates(cell_type, xdtype)
+
+    b, flops = {}, {}
+    for sf in (False, True):
+        compiled_forms, module, code = ffcx.codegeneration.jit.compile_forms(
+            [L],
+            cache_dir=f"./ffcx-cache-{sf}",
+            options={"scalar_type": dtype, "sum_factorization": sf},
+        )
+        form0 = compiled_forms[0]
+        integral = form0.form_integrals[form0.form_integral_offsets[module.lib.cell]]
+        kernel = getattr(integral, f"tabulate_tensor_{dtype}")
+        flops[sf] = integral.flops_per_call
+        ffi = module.ffi
+        b[sf] = np.zeros(ndofs, dtype=dtype)
+        kernel(
+            ffi.cast(f"{c_type} *", b[sf].ctypes.data),
+            ffi.cast(f"{c_type} *", w.ctypes.data),
+            ffi.cast(f"{c_type} *", c.ctypes.data),
+            ffi.cast(f"{c_xtype} *", x.ctypes.data),
+            ffi.NULL,
+            ffi.NULL,
+            ffi.NULL,
+        )
+
+    np.testing.assert_allclose(b[False], b[True], rtol=1e-5, atol=1e-5)
+    if P == 3:
+        # Staged contractions are cheaper than the loop over all dofs and points
+        assert flops[True] < flops[False]